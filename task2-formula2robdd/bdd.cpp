@@ -1,97 +1,441 @@
+#include <algorithm>
+#include <stdexcept>
+
 #include "bdd.h"
 
 namespace model::bdd {
 
-const Node Bdd::zero(-1, nullptr, nullptr);
-const Node Bdd::one (-1, nullptr, nullptr);
+static size_t hash_children(NodeRef low, NodeRef high) {
+    // Fibonacci hashing of both children, the high bits are the best mixed
+    uint64_t key = (uint64_t(low) << 32 | high) * 0x9E3779B97F4A7C15ull;
+    return size_t(key >> 32);
+}
+
+
+Bdd::Bdd(size_t gc_threshold): _gc_threshold(gc_threshold) {
+    _nodes.emplace_back(-1, one, one);
+    _refs.push_back(0);
+    _cache.resize(MIN_CACHE);
+}
+
+
+NodeRef Bdd::make_node(int var, NodeRef low, NodeRef high) {
+    // second rule of Reduce: no redundant vertices
+    if (low == high)
+        return low;
+    // (var, low, high) = !(var, !low, !high)
+    if (high & 1)
+        return make_node(var, low ^ 1, high ^ 1) ^ 1;
+    if (var >= int(_unique.size()))
+        add_var(var);
+    auto &table = _unique[var];
+    if ((table.count + 1) * 4 > table.slots.size() * 3)
+        grow(table);
+
+    size_t mask = table.slots.size() - 1;
+    for (size_t i = hash_children(low, high) & mask;; i = (i + 1) & mask) {
+        uint32_t index = table.slots[i];
+        if (index == UniqueTable::EMPTY) {
+            if (!_free.empty()) {
+                index = _free.back();
+                _free.pop_back();
+                _nodes[index] = Node(var, low, high);
+            } else {
+                if (_nodes.size() > UINT32_MAX >> 1)
+                    throw std::length_error("Too many BDD nodes");
+                index = uint32_t(_nodes.size());
+                _nodes.emplace_back(var, low, high);
+                _refs.push_back(0);
+            }
+            table.slots[i] = index;
+            table.count++;
+            return index << 1;
+        }
+        const Node &node = _nodes[index];
+        if (node.low == low and node.high == high)
+            return index << 1;
+    }
+}
+
+
+void Bdd::add_var(int var) {
+    for (int new_var = int(_unique.size()); new_var <= var; new_var++) {
+        _level.push_back(int(_var_at_level.size()));
+        _var_at_level.push_back(new_var);
+    }
+    _unique.resize(var + 1);
+}
+
+
+void Bdd::insert_node(UniqueTable &table, uint32_t index) {
+    // the node is known to be new
+    if ((table.count + 1) * 4 > table.slots.size() * 3)
+        grow(table);
+    size_t mask = table.slots.size() - 1;
+    size_t i = hash_children(_nodes[index].low, _nodes[index].high) & mask;
+    while (table.slots[i] != UniqueTable::EMPTY)
+        i = (i + 1) & mask;
+    table.slots[i] = index;
+    table.count++;
+}
+
+
+void Bdd::remove_node(uint32_t index) {
+    auto &table = _unique[_nodes[index].var];
+    size_t mask = table.slots.size() - 1;
+    size_t i = hash_children(_nodes[index].low, _nodes[index].high) & mask;
+    while (table.slots[i] != index)
+        i = (i + 1) & mask;
+
+    // backward shift: the following nodes of the run move to the hole if their probe
+    // sequence passes it, so that lookups never stop at the hole too early
+    for (size_t j = (i + 1) & mask; table.slots[j] != UniqueTable::EMPTY; j = (j + 1) & mask) {
+        const Node &node = _nodes[table.slots[j]];
+        size_t home = hash_children(node.low, node.high) & mask;
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            table.slots[i] = table.slots[j];
+            i = j;
+        }
+    }
+    table.slots[i] = UniqueTable::EMPTY;
+    table.count--;
+}
+
+
+void Bdd::grow(UniqueTable &table) {
+    std::vector<uint32_t> slots(std::max(UniqueTable::MIN_CAPACITY, table.slots.size() * 2), UniqueTable::EMPTY);
+    size_t mask = slots.size() - 1;
+    for (uint32_t index : table.slots) {
+        if (index == UniqueTable::EMPTY)
+            continue;
+        size_t i = hash_children(_nodes[index].low, _nodes[index].high) & mask;
+        while (slots[i] != UniqueTable::EMPTY)
+            i = (i + 1) & mask;
+        slots[i] = index;
+    }
+    table.slots.swap(slots);
+}
 
 
-int find_least_variable(const Formula &formula) {
+Root Bdd::create(const Formula &formula) {
+    // subformulae are shared by reference, so each one is built once;
+    // their roots keep them while the garbage is collected between the steps
+    std::unordered_map<const Formula *, Root> created;
+    return create(formula, created);
+}
+
+
+Root Bdd::create(const Formula &formula, std::unordered_map<const Formula *, Root> &created) {
     switch (formula.kind()) {
         case Formula::FALSE:
+            return constant(false);
         case Formula::TRUE:
-            return INT_MAX;
+            return constant(true);
         case Formula::VAR:
-            return formula.var();
-        case Formula::NOT:
-            return find_least_variable(formula.arg());
+            maybe_collect();
+            return Root(*this, make_node(formula.var(), zero, one));
+        default:
+            break;
+    }
+
+    auto it = created.find(&formula);
+    if (it != created.end())
+        return it->second;
+    Root result;
+    if (formula.kind() == Formula::NOT) {
+        result = !create(formula.arg(), created);
+    } else {
+        Root lhs = create(formula.lhs(), created);
+        Root rhs = create(formula.rhs(), created);
+        maybe_collect();
+        result = Root(*this, apply(formula.kind(), lhs.ref(), rhs.ref()));
+    }
+    created.emplace(&formula, result);
+    return result;
+}
+
+
+Root Bdd::constant(bool value) {
+    return Root(*this, value ? one : zero);
+}
+
+
+void Bdd::check(const Root &root) const {
+    if (root.bdd() != this)
+        throw std::invalid_argument("The root belongs to another BDD");
+}
+
+
+Root Bdd::apply(Formula::Kind op, const Root &f, const Root &g) {
+    check(f);
+    check(g);
+    maybe_collect();
+    return Root(*this, apply(op, f.ref(), g.ref()));
+}
+
+
+Root Bdd::ite(const Root &f, const Root &g, const Root &h) {
+    check(f);
+    check(g);
+    check(h);
+    maybe_collect();
+    return Root(*this, ite(f.ref(), g.ref(), h.ref()));
+}
+
+
+Root Bdd::negate(const Root &f) {
+    check(f);
+    return !f;
+}
+
+
+Root Bdd::restrict(const Root &f, int var, bool value) {
+    check(f);
+    maybe_collect();
+    return Root(*this, restrict(f.ref(), var, value));
+}
+
+
+NodeRef Bdd::apply(Formula::Kind op, NodeRef f, NodeRef g) {
+    switch (op) {
         case Formula::AND:
+            return ite(f, g, zero);
         case Formula::OR:
+            return ite(f, one, g);
         case Formula::XOR:
+            return ite(f, negate(g), g);
         case Formula::IMPL:
+            return ite(f, g, one);
         case Formula::EQ:
-            return std::min(find_least_variable(formula.lhs()), find_least_variable(formula.rhs()));
+            return ite(f, g, negate(g));
+        default:
+            throw std::invalid_argument("Not a binary operation");
     }
-    return INT_MAX;
 }
 
 
-const Node& Bdd::create(const Formula &formula) {
-    if (formula.kind() == Formula::FALSE)
-        return zero;
-    if (formula.kind() == Formula::TRUE)
-        return one;
+NodeRef Bdd::ite(NodeRef f, NodeRef g, NodeRef h) {
+    if (f == one)
+        return g;
+    if (f == zero)
+        return h;
+    // ite(f, f, h) = ite(f, 1, h), ite(f, !f, h) = ite(f, 0, h) and the same for h
+    if (g == f)
+        g = one;
+    else if (g == negate(f))
+        g = zero;
+    if (h == f)
+        h = zero;
+    else if (h == negate(f))
+        h = one;
+
+    // terminal cases
+    if (g == h)
+        return g;
+    if (g == one and h == zero)
+        return f;
+    if (g == zero and h == one)
+        return negate(f);
+    // ite(!f, g, h) = ite(f, h, g) and ite(f, !g, !h) = !ite(f, g, h): only regular f and g
+    // go to the cache, so the equivalent calls share the entry
+    if (f & 1) {
+        f ^= 1;
+        std::swap(g, h);
+    }
+    NodeRef complement = g & 1;
+    g ^= complement;
+    h ^= complement;
+
+    NodeRef result;
+    if (lookup(CacheEntry::ITE, f, g, h, result))
+        return result ^ complement;
+
+    // Shannon expansion by the top variable of the three
+    int level = std::min({top_level(f), top_level(g), top_level(h)});
+    auto low = [this, level](NodeRef ref) { return top_level(ref) == level ? this->low(ref) : ref; };
+    auto high = [this, level](NodeRef ref) { return top_level(ref) == level ? this->high(ref) : ref; };
+    NodeRef r_low = ite(low(f), low(g), low(h));
+    NodeRef r_high = ite(high(f), high(g), high(h));
+    result = make_node(_var_at_level[level], r_low, r_high);
+
+    insert(CacheEntry::ITE, f, g, h, result);
+    return result ^ complement;
+}
+
+
+NodeRef Bdd::restrict(NodeRef f, int var, bool value) {
+    // no node depends on a variable without a level
+    if (var < 0 or var >= int(_level.size()) or top_level(f) > _level[var])
+        return f;
+    if (top_level(f) == _level[var])
+        return value ? high(f) : low(f);
+
+    // restrict(!f) = !restrict(f)
+    NodeRef complement = f & 1;
+    f ^= complement;
+    NodeRef result;
+    if (lookup(CacheEntry::RESTRICT, f, NodeRef(var), value, result))
+        return result ^ complement;
+    Node node = _nodes[f >> 1];
+    NodeRef r_low = restrict(node.low, var, value);
+    NodeRef r_high = restrict(node.high, var, value);
+    result = make_node(node.var, r_low, r_high);
+    insert(CacheEntry::RESTRICT, f, NodeRef(var), value, result);
+    return result ^ complement;
+}
+
 
-    if (formula.kind() == Formula::VAR) {
-        auto node_tuple = std::make_tuple(formula.var(), &zero, &one);
-        auto node_it = _nodes.find(node_tuple);
-        if (node_it != _nodes.end()){
-            return node_it->second;
+static size_t hash_operation(uint32_t op, NodeRef f, NodeRef g, NodeRef h) {
+    uint64_t key = ((uint64_t(f) << 32 | g) ^ (uint64_t(h) << 8 | op)) * 0x9E3779B97F4A7C15ull;
+    return size_t(key >> 32 ^ key);
+}
+
+
+bool Bdd::lookup(uint32_t op, NodeRef f, NodeRef g, NodeRef h, NodeRef &result) const {
+    const CacheEntry &entry = _cache[hash_operation(op, f, g, h) & (_cache.size() - 1)];
+    if (entry.op != op or entry.f != f or entry.g != g or entry.h != h)
+        return false;
+    result = entry.result;
+    return true;
+}
+
+
+void Bdd::insert(uint32_t op, NodeRef f, NodeRef g, NodeRef h, NodeRef result) {
+    if (_cache.size() < MAX_CACHE and _nodes.size() > _cache.size()) {
+        // the old entries are dropped, the table only keeps recent results anyway
+        _cache.assign(std::max(MIN_CACHE, _cache.size() * 2), CacheEntry());
+    }
+    CacheEntry &entry = _cache[hash_operation(op, f, g, h) & (_cache.size() - 1)];
+    entry.op = op;
+    entry.f = f;
+    entry.g = g;
+    entry.h = h;
+    entry.result = result;
+}
+
+
+size_t Bdd::size(const Root &root) const {
+    check(root);
+    std::vector<bool> visited(_nodes.size());
+    std::vector<uint32_t> stack = {root.ref() >> 1};
+    size_t count = 0;
+    while (!stack.empty()) {
+        uint32_t index = stack.back();
+        stack.pop_back();
+        if (visited[index])
+            continue;
+        visited[index] = true;
+        count++;
+        if (index != 0) {
+            stack.push_back(_nodes[index].low >> 1);
+            stack.push_back(_nodes[index].high >> 1);
         }
-        _nodes.emplace(node_tuple, Node(formula.var(), &zero, &one));
-        return _nodes[node_tuple];
     }
-    // find variable x with the least number
-    int v_num = find_least_variable(formula);
-    if (v_num == INT_MAX) {
-        bool value = formula();
-        return value ? one : zero;
+    return count;
+}
+
+
+size_t Bdd::memory_bytes() const {
+    size_t bytes = _nodes.capacity() * sizeof(Node) + _refs.capacity() * sizeof(uint32_t)
+                   + _free.capacity() * sizeof(uint32_t) + _cache.capacity() * sizeof(CacheEntry);
+    for (const auto &table : _unique)
+        bytes += table.slots.capacity() * sizeof(uint32_t);
+    return bytes;
+}
+
+
+void Bdd::maybe_collect() {
+    if (size() >= _gc_threshold)
+        collect_garbage();
+    if (_auto_reorder and size() >= 2 * _reorder_size)
+        sift();
+}
+
+
+void Bdd::collect_garbage() {
+    // mark the nodes reachable from the roots
+    std::vector<bool> live(_nodes.size());
+    std::vector<uint32_t> stack;
+    live[0] = true;
+    for (uint32_t index = 1; index < _nodes.size(); index++)
+        if (_refs[index] > 0)
+            stack.push_back(index);
+    while (!stack.empty()) {
+        uint32_t index = stack.back();
+        stack.pop_back();
+        if (live[index])
+            continue;
+        live[index] = true;
+        stack.push_back(_nodes[index].low >> 1);
+        stack.push_back(_nodes[index].high >> 1);
     }
 
-    // Apply (F * G) = Reduce ( Compose (x, Apply (F|x=1 * G|x=1), Apply (F|x=0 * G|x=0) ) )
-    auto &high = create(formula(v_num, true));
-    auto &low = create(formula(v_num, false));
-    if (&low == &high) {
-        // second rule of Reduce: delete redundant vertex
-        return high;
+    // the cached results are kept while all their nodes live
+    for (auto &entry : _cache) {
+        bool dead = entry.op != CacheEntry::NONE and (!live[entry.f >> 1] or !live[entry.result >> 1]);
+        dead = dead or (entry.op == CacheEntry::ITE and (!live[entry.g >> 1] or !live[entry.h >> 1]));
+        if (dead)
+            entry.op = CacheEntry::NONE;
     }
 
-    auto node_tuple = std::make_tuple(v_num, &low, &high);
-    auto node_it = _nodes.find(node_tuple);
-    if (node_it != _nodes.end()){
-        return node_it->second;
+    // sweep: the arena loses its dead tail, the other dead nodes go to the free list
+    // with the lowest indices taken first, and the unique tables are built anew
+    size_t end = _nodes.size();
+    while (!live[end - 1])
+        end--;
+    _nodes.resize(end);
+    _refs.resize(end);
+    _free.clear();
+    for (auto &table : _unique)
+        table.count = 0;
+    for (uint32_t index = uint32_t(end) - 1; index > 0; index--) {
+        if (live[index])
+            _unique[_nodes[index].var].count++;
+        else
+            _free.push_back(index);
+    }
+    for (auto &table : _unique) {
+        size_t capacity = UniqueTable::MIN_CAPACITY;
+        while ((table.count + 1) * 4 > capacity * 3)
+            capacity *= 2;
+        table.slots.assign(capacity, UniqueTable::EMPTY);
+        table.count = 0;
+    }
+    for (uint32_t index = 1; index < end; index++) {
+        if (live[index])
+            insert_node(_unique[_nodes[index].var], index);
     }
-    _nodes.emplace(node_tuple, Node(v_num, &low, &high));
-    return _nodes[node_tuple];
 
+    _collections++;
+    _gc_threshold = std::max(_gc_threshold, 2 * size());
 }
 
 
-void print_bdd(std::ostream &out, const std::string &prefix, const Node &node, bool is_left) {
+void print_bdd(std::ostream &out, const std::string &prefix, const Bdd &bdd, NodeRef ref, bool is_left) {
     out << prefix;
     out << (is_left ? "├──" : "└──" );
 
     // print the value of the node
-    if (&node == &Bdd::zero) {
+    if (ref == Bdd::zero) {
         out << "zero" << std::endl;
         return;
     }
-    if (&node == &Bdd::one) {
+    if (ref == Bdd::one) {
         out << "one" << std::endl;
         return;
     }
-    out << "x" << node.var << std::endl;
+    out << "x" << bdd.var(ref) << std::endl;
 
     // enter the next tree level - left and right branch
-    if (node.low != nullptr)
-        print_bdd(out, prefix + (is_left ? "│   " : "    "), *node.low, true);
-    if (node.high != nullptr)
-        print_bdd(out, prefix + (is_left ? "│   " : "    "), *node.high, false);
+    print_bdd(out, prefix + (is_left ? "│   " : "    "), bdd, bdd.low(ref), true);
+    print_bdd(out, prefix + (is_left ? "│   " : "    "), bdd, bdd.high(ref), false);
 }
 
 
-std::ostream& operator <<(std::ostream &out, const Node &node) {
-    print_bdd(out, "", node, false);
+std::ostream& operator <<(std::ostream &out, const Root &root) {
+    if (root.bdd() == nullptr)
+        return out << "└──none" << std::endl;
+    print_bdd(out, "", *root.bdd(), root.ref(), false);
     return out;
 }
 
@@ -1,8 +1,10 @@
 #pragma once
 
-#include <memory>
-#include <map>
 #include <climits>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
 
 #include "formula.h"
 
@@ -10,32 +12,229 @@ using namespace model::logic;
 
 namespace model::bdd {
 
+// Edge to a node of its Bdd: the index of the node in the arena shifted left by one,
+// the lowest bit set for the negation of the function of the node (complement edge).
+using NodeRef = uint32_t;
+
 struct Node final {
     int var;
 
-    const Node *low;
-    const Node *high;
+    NodeRef low;
+    NodeRef high; // never complemented, so that every function has one representation
 
-    Node(): var(), low(nullptr), high(nullptr) {}
+    Node(): var(), low(0), high(0) {}
 
-    Node(int var, const Node *low, const Node *high):
+    Node(int var, NodeRef low, NodeRef high):
         var(var), low(low), high(high) {}
 };
 
+class Root;
+
 class Bdd final {
 public:
-    static const Node zero;
-    static const Node one;
+    // the only terminal node is one, zero is the complement edge to it
+    static constexpr NodeRef one = 0;
+    static constexpr NodeRef zero = 1;
+
+    static constexpr size_t DEFAULT_GC_THRESHOLD = 1 << 20;
+
+    // Garbage is collected when an operation starts with at least gc_threshold nodes in the arena.
+    explicit Bdd(size_t gc_threshold = DEFAULT_GC_THRESHOLD);
+
+    // The roots point to the Bdd, so it stays in place.
+    Bdd(const Bdd &) = delete;
+    Bdd& operator =(const Bdd &) = delete;
+
+    // Builds the formula bottom-up with apply, every subformula once.
+    Root create(const Formula &formula);
+    Root constant(bool value);
+
+    // Operations on the roots of this Bdd; op is one of the binary kinds of Formula.
+    Root apply(Formula::Kind op, const Root &f, const Root &g);
+    // if f then g else h
+    Root ite(const Root &f, const Root &g, const Root &h);
+    Root negate(const Root &f);
+    // f with the variable var replaced by value
+    Root restrict(const Root &f, int var, bool value);
+
+    // The variable of a non-terminal root and its cofactors, with the complement of the edge
+    // pushed down to the children.
+    [[nodiscard]] int var(NodeRef ref) const { return _nodes[ref >> 1].var; }
+    [[nodiscard]] NodeRef low(NodeRef ref) const { return _nodes[ref >> 1].low ^ (ref & 1); }
+    [[nodiscard]] NodeRef high(NodeRef ref) const { return _nodes[ref >> 1].high ^ (ref & 1); }
+
+    // Number of nodes, live or not yet collected, the terminal included.
+    [[nodiscard]] size_t size() const { return _nodes.size() - _free.size(); }
+    // Number of nodes reachable from the root, the terminal included.
+    [[nodiscard]] size_t size(const Root &root) const;
+    // Memory of the arena, the unique tables and the computed table.
+    [[nodiscard]] size_t memory_bytes() const;
+    [[nodiscard]] size_t collections() const { return _collections; }
+
+    // Frees the nodes unreachable from the roots and forgets the cached results that mention them.
+    // Plain NodeRefs of the freed nodes become invalid.
+    void collect_garbage();
+
+    // Variables from the top level down; a new variable goes below the known ones,
+    // so by default the order is ascending.
+    [[nodiscard]] const std::vector<int>& order() const { return _var_at_level; }
+    [[nodiscard]] int level(int var) const { return _level[var]; }
+    // Moves the variables to the given levels by swaps of adjacent levels; the order is
+    // a permutation of the known variables and maybe some new ones. Roots keep their functions,
+    // the nodes are rewritten in place, dead ones are freed.
+    void set_order(const std::vector<int> &order);
+    // Rudell's sifting: every variable, those with more nodes first, is moved through the levels
+    // and left on the one where the BDD was the smallest.
+    void sift();
+    // Sifting runs by itself when an operation starts with twice the nodes left by the last one.
+    void set_auto_reorder(bool enabled) { _auto_reorder = enabled; }
+    [[nodiscard]] size_t reorderings() const { return _reorderings; }
+
+private:
+    friend class Root;
+
+    // Nodes of one variable keyed by (low, high): open addressing with linear probing
+    // over a power-of-two array of node indices, so a lookup touches one or two cache lines
+    // of the table and the node it finds.
+    struct UniqueTable final {
+        static constexpr uint32_t EMPTY = UINT32_MAX;
+        static constexpr size_t MIN_CAPACITY = 8;
+
+        std::vector<uint32_t> slots;
+        size_t count = 0;
+    };
+
+    // Results of the recent operations, a direct-mapped table where a new entry
+    // replaces the old one with the same hash.
+    struct CacheEntry final {
+        enum Op : uint32_t { NONE, ITE, RESTRICT };
+
+        uint32_t op = NONE;
+        NodeRef f = 0;
+        NodeRef g = 0;
+        NodeRef h = 0;
+        NodeRef result = 0;
+    };
+    static constexpr size_t MIN_CACHE = 1 << 12;
+    static constexpr size_t MAX_CACHE = 1 << 22;
+    // no automatic sifting below this size
+    static constexpr size_t MIN_REORDER_SIZE = 4096;
+    // a variable is not moved further in a direction where the BDD has grown that much
+    static constexpr double MAX_GROWTH = 1.2;
+
+    // Returns the edge to the only node (var, low, high), creating it if needed, or low if both
+    // children are the same; a complemented high child is moved to the returned edge.
+    NodeRef make_node(int var, NodeRef low, NodeRef high);
+    void grow(UniqueTable &table);
+    void insert_node(UniqueTable &table, uint32_t index);
+    void remove_node(uint32_t index);
+    // Puts the variable and all the smaller new ones on the levels below the known ones.
+    void add_var(int var);
+
+    // The level of a node, INT_MAX for the terminal that is below all variables.
+    [[nodiscard]] int top_level(NodeRef ref) const { return ref <= zero ? INT_MAX : _level[_nodes[ref >> 1].var]; }
+    Root create(const Formula &formula, std::unordered_map<const Formula *, Root> &created);
+    void check(const Root &root) const;
+    // Collects the garbage if the arena has reached the threshold and sifts if the BDD has doubled;
+    // only called between the recursive operations, when every node in use is reachable from a root.
+    void maybe_collect();
+
+    // Reordering (reorder.cpp) keeps the exact number of references of every node.
+    void begin_reorder();
+    void end_reorder();
+    // Swaps the variables of the level and of the next one.
+    void swap_levels(int level);
+    // Drops one reference to the node, freeing it and its descendants that are left without any.
+    void release(uint32_t index);
+    void sift_var(int var);
+
+    // The recursive operations on the nodes, no garbage is collected inside.
+    NodeRef apply(Formula::Kind op, NodeRef f, NodeRef g);
+    NodeRef ite(NodeRef f, NodeRef g, NodeRef h);
+    NodeRef restrict(NodeRef f, int var, bool value);
+    static NodeRef negate(NodeRef f) { return f ^ 1; }
+
+    bool lookup(uint32_t op, NodeRef f, NodeRef g, NodeRef h, NodeRef &result) const;
+    void insert(uint32_t op, NodeRef f, NodeRef g, NodeRef h, NodeRef result);
+
+    // Arena of all nodes, the terminal is the first one.
+    std::vector<Node> _nodes;
+    // Number of roots of every node.
+    std::vector<uint32_t> _refs;
+    // Indices of the freed nodes, reused before the arena grows.
+    std::vector<uint32_t> _free;
+    // Unique table of every variable, grown at 3/4 load.
+    std::vector<UniqueTable> _unique;
+    // Computed table, grown with the arena up to MAX_CACHE entries.
+    std::vector<CacheEntry> _cache;
+
+    // Level of every variable and the variable of every level.
+    std::vector<int> _level;
+    std::vector<int> _var_at_level;
+    // References of every node from other nodes and from roots, only while reordering.
+    std::vector<uint32_t> _parents;
+
+    // Raised to twice the live nodes after a collection, so that it does not run again at once.
+    size_t _gc_threshold;
+    size_t _collections = 0;
+    bool _auto_reorder = true;
+    // Number of nodes after the last sifting.
+    size_t _reorder_size = MIN_REORDER_SIZE;
+    size_t _reorderings = 0;
+};
+
+// Reference to a function in a Bdd that keeps its nodes from garbage collection.
+// The Bdd has to outlive its roots.
+class Root final {
+public:
+    Root() = default;
+
+    Root(Bdd &bdd, NodeRef ref): _bdd(&bdd), _ref(ref) { _bdd->_refs[_ref >> 1]++; }
+
+    Root(const Root &other): Root() { *this = other; }
+
+    Root(Root &&other) noexcept: _bdd(other._bdd), _ref(other._ref) { other._bdd = nullptr; }
+
+    ~Root() { release(); }
+
+    Root& operator =(const Root &other) {
+        if (other._bdd != nullptr)
+            other._bdd->_refs[other._ref >> 1]++;
+        release();
+        _bdd = other._bdd;
+        _ref = other._ref;
+        return *this;
+    }
+
+    Root& operator =(Root &&other) noexcept {
+        if (this != &other) {
+            release();
+            _bdd = other._bdd;
+            _ref = other._ref;
+            other._bdd = nullptr;
+        }
+        return *this;
+    }
+
+    [[nodiscard]] Bdd* bdd() const { return _bdd; }
+    [[nodiscard]] NodeRef ref() const { return _ref; }
+
+    Root operator !() const { return Root(*_bdd, _ref ^ 1); }
 
-    const Node& create(const Formula &formula);
+    bool operator ==(const Root &other) const { return _bdd == other._bdd and _ref == other._ref; }
+    bool operator !=(const Root &other) const { return !(*this == other); }
 
 private:
-    // Pool of nodes organized so as to efficiently
-    // search for a given (var, low, high).
-    std::map<std::tuple<int, const Node *, const Node *>, const Node> _nodes;
+    void release() {
+        if (_bdd != nullptr)
+            _bdd->_refs[_ref >> 1]--;
+        _bdd = nullptr;
+    }
 
+    Bdd *_bdd = nullptr;
+    NodeRef _ref = Bdd::zero;
 };
 
-std::ostream& operator <<(std::ostream &out, const Node &node);
+std::ostream& operator <<(std::ostream &out, const Root &root);
 
 } // namespace model::bdd
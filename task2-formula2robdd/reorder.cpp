@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "bdd.h"
+
+namespace model::bdd {
+
+void Bdd::begin_reorder() {
+    // only the live nodes are counted, so the size of the arena is the size of the BDD
+    collect_garbage();
+    std::vector<bool> free(_nodes.size());
+    for (uint32_t index : _free)
+        free[index] = true;
+    _parents.assign(_refs.begin(), _refs.end());
+    for (uint32_t index = 1; index < _nodes.size(); index++) {
+        if (free[index])
+            continue;
+        _parents[_nodes[index].low >> 1]++;
+        _parents[_nodes[index].high >> 1]++;
+    }
+}
+
+
+void Bdd::end_reorder() {
+    _parents.clear();
+    _parents.shrink_to_fit();
+    // the functions of the live nodes are the same, but the freed indices may be taken again
+    for (auto &entry : _cache)
+        entry.op = CacheEntry::NONE;
+    _reorderings++;
+}
+
+
+void Bdd::release(uint32_t index) {
+    std::vector<uint32_t> stack = {index};
+    while (!stack.empty()) {
+        index = stack.back();
+        stack.pop_back();
+        if (index == 0 or --_parents[index] > 0)
+            continue;
+        remove_node(index);
+        _free.push_back(index);
+        stack.push_back(_nodes[index].low >> 1);
+        stack.push_back(_nodes[index].high >> 1);
+    }
+}
+
+
+void Bdd::swap_levels(int level) {
+    int x = _var_at_level[level];
+    int y = _var_at_level[level + 1];
+
+    // the nodes of x without children of y just go one level down
+    std::vector<uint32_t> moved;
+    for (uint32_t index : _unique[x].slots) {
+        if (index == UniqueTable::EMPTY)
+            continue;
+        const Node &node = _nodes[index];
+        if (_nodes[node.low >> 1].var == y or _nodes[node.high >> 1].var == y)
+            moved.push_back(index);
+    }
+
+    auto make_child = [this, x](NodeRef low, NodeRef high) {
+        size_t nodes = size();
+        NodeRef ref = make_node(x, low, high);
+        uint32_t index = ref >> 1;
+        if (size() > nodes) {
+            if (index >= _parents.size())
+                _parents.resize(index + 1);
+            _parents[index] = 0;
+            _parents[_nodes[index].low >> 1]++;
+            _parents[_nodes[index].high >> 1]++;
+        }
+        _parents[index]++;
+        return ref;
+    };
+
+    // every other node of x becomes a node of y with the same function, rewritten in place:
+    // x ? (y ? f11 : f10) : (y ? f01 : f00) = y ? (x ? f11 : f01) : (x ? f10 : f00)
+    for (uint32_t index : moved) {
+        remove_node(index);
+        NodeRef f0 = _nodes[index].low;
+        NodeRef f1 = _nodes[index].high;
+        auto cofactor = [this, y](NodeRef ref, bool value) {
+            if (ref <= zero or var(ref) != y)
+                return ref;
+            return value ? high(ref) : low(ref);
+        };
+        NodeRef low = make_child(cofactor(f0, false), cofactor(f1, false));
+        NodeRef high = make_child(cofactor(f0, true), cofactor(f1, true));
+        // high is regular, since f1 and its cofactors are
+        _nodes[index] = Node(y, low, high);
+        insert_node(_unique[y], index);
+        release(f0 >> 1);
+        release(f1 >> 1);
+    }
+
+    std::swap(_var_at_level[level], _var_at_level[level + 1]);
+    _level[x] = level + 1;
+    _level[y] = level;
+}
+
+
+void Bdd::sift_var(int var) {
+    int levels = int(_var_at_level.size());
+    int start = _level[var];
+    int level = start;
+    auto move_to = [this, &level](int target) {
+        for (; level < target; level++)
+            swap_levels(level);
+        for (; level > target; level--)
+            swap_levels(level - 1);
+    };
+
+    // to the nearer end first, then back and to the other one; the size only depends on the order,
+    // so it is the same again at the start
+    size_t best_size = size();
+    int best_level = start;
+    int first = start < levels / 2 ? -1 : 1;
+    for (int direction : {first, -first}) {
+        move_to(start);
+        while (direction < 0 ? level > 0 : level < levels - 1) {
+            move_to(level + direction);
+            if (size() < best_size) {
+                best_size = size();
+                best_level = level;
+            }
+            if (double(size()) > MAX_GROWTH * double(best_size))
+                break;
+        }
+    }
+    move_to(best_level);
+}
+
+
+void Bdd::sift() {
+    begin_reorder();
+    std::vector<int> vars = _var_at_level;
+    std::stable_sort(vars.begin(), vars.end(), [this](int a, int b) {
+        return _unique[a].count > _unique[b].count;
+    });
+    for (int var : vars)
+        sift_var(var);
+    end_reorder();
+    _reorder_size = std::max(MIN_REORDER_SIZE, size());
+}
+
+
+void Bdd::set_order(const std::vector<int> &order) {
+    int max_var = order.empty() ? -1 : *std::max_element(order.begin(), order.end());
+    if (max_var >= int(_unique.size()))
+        add_var(max_var);
+    std::vector<bool> seen(_var_at_level.size());
+    for (int var : order) {
+        if (var < 0 or seen[var])
+            throw std::invalid_argument("The order is not a permutation of the variables");
+        seen[var] = true;
+    }
+    if (order.size() != _var_at_level.size())
+        throw std::invalid_argument("The order is not a permutation of the variables");
+
+    begin_reorder();
+    for (int target = 0; target < int(order.size()); target++) {
+        for (int level = _level[order[target]]; level > target; level--)
+            swap_levels(level - 1);
+    }
+    end_reorder();
+}
+
+} // namespace model::bdd
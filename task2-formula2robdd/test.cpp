@@ -7,6 +7,37 @@
 using namespace model::bdd;
 using namespace model::logic;
 
+// (x0 == xn) && ... && (x(n-1) == x(2n-1)), exponential in the ascending order
+const Formula& pairs_equal(int n) {
+    const Formula *formula = &T;
+    for (int i = 0; i < n; i++)
+        formula = &(*formula && (x(i) == x(i + n)));
+    return *formula;
+}
+
+// x0 != x1 != ... != x(n-1)
+const Formula& parity(int n) {
+    const Formula *formula = &x(0);
+    for (int i = 1; i < n; i++)
+        formula = &(*formula != x(i));
+    return *formula;
+}
+
+// the values of the formula and of its BDD agree on all assignments to x0..x(n-1)
+bool same_function(Bdd &bdd, const Root &root, const Formula &formula, int n) {
+    for (unsigned bits = 0; bits < (1u << n); bits++) {
+        const Formula *assigned = &formula;
+        Root restricted = root;
+        for (int var = 0; var < n; var++) {
+            assigned = &(*assigned)(var, bits >> var & 1);
+            restricted = bdd.restrict(restricted, var, bits >> var & 1);
+        }
+        if (restricted != bdd.constant((*assigned)()))
+            return false;
+    }
+    return true;
+}
+
 int main() {
     const Formula &formula1 =  x(0) >>  x(1);
     const Formula &formula2 = !x(1) >> !x(0);
@@ -18,26 +49,92 @@ int main() {
  
     Bdd bdd;
 
-    const Node& root1 = bdd.create(formula1);
+    Root root1 = bdd.create(formula1);
     std::cout << formula1 << std::endl << root1 << std::endl;
-    const Node& root2 = bdd.create(formula2);
+    Root root2 = bdd.create(formula2);
     std::cout << formula2 << std::endl << root2 << std::endl;
-    assert(&root1 == &root2);
+    assert(root1 == root2);
 
-    const Node& root3 = bdd.create(formula3);
+    Root root3 = bdd.create(formula3);
     std::cout << formula3 << std::endl << root3 << std::endl;
-    const Node& root4 = bdd.create(formula4);
+    Root root4 = bdd.create(formula4);
     std::cout << formula4 << std::endl << root4 << std::endl;
-    assert(&root3 == &root4);
+    assert(root3 == root4);
 
-    const Node& root5 = bdd.create(formula5);
+    Root root5 = bdd.create(formula5);
     std::cout << formula5 << std::endl << root5 << std::endl;
-    const Node& root6 = bdd.create(formula6);
+    Root root6 = bdd.create(formula6);
     std::cout << formula6 << std::endl << root6 << std::endl;
-    const Node& root7 = bdd.create(formula7);
+    Root root7 = bdd.create(formula7);
     std::cout << formula7 << std::endl << root7 << std::endl;
-    assert(&root5 == &root6);
-    assert(&root6 == &root7);
+    assert(root5 == root6);
+    assert(root6 == root7);
+
+    // 2^i nodes on the levels i < n and 2^(2n-i) on the others, but the two nodes of the last level
+    // are the complements of each other; the unique tables grow several times
+    const int n = 6;
+    Bdd pairs;
+    Root pairs_root = pairs.create(pairs_equal(n));
+    assert(pairs.size(pairs_root) == 3 * (1u << n) - 3);
+    size_t nodes = pairs.size();
+    assert(pairs.create(pairs_equal(n)) == pairs_root);
+    assert(pairs.size() == nodes);
+
+    for (const Formula *formula : {&formula1, &formula3, &formula5, &formula7, &(x(2) >> ((x(0) && !x(3)) || x(1)))})
+        assert(same_function(bdd, bdd.create(*formula), *formula, 4));
+    assert(bdd.apply(Formula::AND, root1, bdd.negate(root1)) == bdd.constant(false));
+    assert(bdd.ite(root5, bdd.constant(false), bdd.constant(true)) == !root5);
+
+    // negation is a complement edge to the same nodes, one node per variable for the parity
+    nodes = bdd.size();
+    assert(bdd.create(!formula5) == bdd.negate(root5));
+    assert(bdd.create(x(0) == x(1)) == bdd.negate(root5));
+    assert(bdd.size() == nodes);
+    assert(bdd.size(root5) == 3);
+
+    // formulae over many variables are built without enumerating the assignments
+    Bdd large;
+    assert(large.size(large.create(parity(64))) == 64 + 1);
+    Bdd interleaved;
+    const Formula *formula = &T;
+    for (int i = 0; i < 20; i++)
+        formula = &(*formula && (x(2 * i) == x(2 * i + 1)));
+    assert(interleaved.size(interleaved.create(*formula)) == 3 * 20);
+
+    // with a small threshold the dropped BDDs are collected and their nodes reused,
+    // the kept ones stay valid
+    Bdd collected(1000);
+    Root kept = collected.create(pairs_equal(4));
+    for (int round = 0; round < 50; round++) {
+        Root dropped = collected.create(pairs_equal(5) != x(10 + round));
+        assert(collected.size() < 2000);
+    }
+    assert(collected.collections() > 0);
+    assert(same_function(collected, kept, pairs_equal(4), 8));
+    collected.collect_garbage();
+    assert(collected.size() == collected.size(kept));
+
+    // the order decides the size: pairs_equal is linear when the pairs are neighbours
+    Bdd ordered;
+    ordered.set_auto_reorder(false);
+    Root equal = ordered.create(pairs_equal(5));
+    assert(ordered.size(equal) == 3 * (1u << 5) - 3);
+    ordered.sift();
+    assert(ordered.size(equal) == 3 * 5);
+    assert(same_function(ordered, equal, pairs_equal(5), 10));
+    ordered.set_order({0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    assert(ordered.size(equal) == 3 * (1u << 5) - 3);
+    ordered.set_order({0, 5, 1, 6, 2, 7, 3, 8, 4, 9});
+    assert(ordered.size(equal) == 3 * 5);
+    assert(ordered.order()[1] == 5 and ordered.level(5) == 1);
+    assert(ordered.create(pairs_equal(5)) == equal);
+    assert(same_function(ordered, equal, pairs_equal(5), 10));
+
+    // sifting starts by itself while the BDD grows
+    Bdd automatic;
+    Root automatic_pairs = automatic.create(pairs_equal(14));
+    assert(automatic.reorderings() > 0);
+    assert(automatic.size(automatic_pairs) < 1000);
 
     return 0;
 }
@@ -0,0 +1,113 @@
+#include <chrono>
+#include <glob.h>
+#include "batch.hpp"
+#include "thread_pool.hpp"
+
+
+std::vector<std::string> expand_paths(const std::vector<std::string> &patterns) {
+    std::vector<std::string> paths;
+    for (const auto &pattern : patterns) {
+        glob_t matches;
+        if (glob(pattern.c_str(), 0, nullptr, &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; i++)
+                paths.emplace_back(matches.gl_pathv[i]);
+        } else {
+            paths.push_back(pattern);
+        }
+        globfree(&matches);
+    }
+    return paths;
+}
+
+
+static BatchResult solve_file(const std::string &path, const SolverConfig &config) {
+    using clock = std::chrono::steady_clock;
+    BatchResult result;
+    result.path = path;
+
+    try {
+        auto t_start = clock::now();
+        CNF cnf(path);
+        auto t_loaded = clock::now();
+        Solver solver(cnf, config);
+        result.result = solver.solve() ? CNF::BoolTernary::TRUE : CNF::BoolTernary::FALSE;
+        auto t_end = clock::now();
+
+        result.load_seconds = std::chrono::duration<double>(t_loaded - t_start).count();
+        result.solve_seconds = std::chrono::duration<double>(t_end - t_loaded).count();
+        result.stats = solver.stats();
+    } catch (const std::exception &e) {
+        result.error = e.what();
+    }
+    return result;
+}
+
+std::vector<BatchResult> solve_batch(const std::vector<std::string> &paths, const SolverConfig &config,
+                                     size_t threads) {
+    std::vector<BatchResult> results(paths.size());
+    ThreadPool pool(threads);
+    for (size_t i = 0; i < paths.size(); i++)
+        pool.submit([&, i]() { results[i] = solve_file(paths[i], config); });
+    pool.wait();
+    return results;
+}
+
+
+static const char* result_name(CNF::BoolTernary result) {
+    switch (result) {
+        case CNF::BoolTernary::TRUE:
+            return "SAT";
+        case CNF::BoolTernary::FALSE:
+            return "UNSAT";
+        case CNF::BoolTernary::UNKNOWN:
+            return "UNKNOWN";
+    }
+    return "UNKNOWN";
+}
+
+static std::string csv_escaped(const std::string &text) {
+    std::string result;
+    for (char c : text) {
+        if (c == '"')
+            result += '"';
+        result += c;
+    }
+    return result;
+}
+
+static std::string json_escaped(const std::string &text) {
+    std::string result;
+    for (char c : text) {
+        if (c == '"' or c == '\\')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+void write_csv(std::ostream &out, const std::vector<BatchResult> &results) {
+    out << "file,result,load_sec,solve_sec,decisions,propagations,conflicts,error" << std::endl;
+    for (const auto &result : results) {
+        out << '"' << csv_escaped(result.path) << "\"," << result_name(result.result) << ','
+            << result.load_seconds << ',' << result.solve_seconds << ','
+            << result.stats.decisions << ',' << result.stats.propagations << ',' << result.stats.conflicts << ','
+            << '"' << csv_escaped(result.error) << '"' << std::endl;
+    }
+}
+
+void write_json(std::ostream &out, const std::vector<BatchResult> &results) {
+    out << "[" << std::endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto &result = results[i];
+        out << "  {\"file\": \"" << json_escaped(result.path) << "\", "
+            << "\"result\": \"" << result_name(result.result) << "\", "
+            << "\"load_sec\": " << result.load_seconds << ", "
+            << "\"solve_sec\": " << result.solve_seconds << ", "
+            << "\"stats\": ";
+        result.stats.write_json(out);
+        if (!result.error.empty())
+            out << ", \"error\": \"" << json_escaped(result.error) << "\"";
+        out << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "]" << std::endl;
+}
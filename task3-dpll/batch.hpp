@@ -0,0 +1,30 @@
+#ifndef TASK3_BATCH_HPP
+#define TASK3_BATCH_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "cnf.hpp"
+#include "solver.hpp"
+
+
+struct BatchResult {
+    std::string path;
+    CNF::BoolTernary result = CNF::BoolTernary::UNKNOWN; // UNKNOWN if the file could not be solved
+    double load_seconds = 0;                               // wall time of reading the file
+    double solve_seconds = 0;                              // wall time of the search
+    SolverStats stats;
+    std::string error;
+};
+
+// expands shell wildcards, a pattern matching nothing is kept as is to be reported as an error
+std::vector<std::string> expand_paths(const std::vector<std::string> &patterns);
+
+// solves every file on a work-stealing pool of threads (0 - one per core), results keep the order of paths
+std::vector<BatchResult> solve_batch(const std::vector<std::string> &paths, const SolverConfig &config,
+                                     size_t threads = 0);
+
+void write_csv(std::ostream &out, const std::vector<BatchResult> &results);
+void write_json(std::ostream &out, const std::vector<BatchResult> &results);
+
+#endif //TASK3_BATCH_HPP
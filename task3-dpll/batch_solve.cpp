@@ -0,0 +1,54 @@
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include "batch.hpp"
+
+
+void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [--json] [--threads N] [--dpll] [--first-unassigned] FILE|GLOB..." << std::endl;
+}
+
+int main(int argc, char **argv) {
+    SolverConfig config;
+    size_t threads = 0;
+    bool json = false;
+    std::vector<std::string> patterns;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (strcmp(argv[i], "--threads") == 0 and i + 1 < argc) {
+            try {
+                threads = std::stoul(argv[++i]);
+            } catch (const std::exception &) { // not a number or too large
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--dpll") == 0) {
+            config.algorithm = CNF::DPLL;
+        } else if (strcmp(argv[i], "--first-unassigned") == 0) {
+            config.heuristic = Heuristic::FIRST_UNASSIGNED;
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            patterns.emplace_back(argv[i]);
+        }
+    }
+    if (patterns.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    auto results = solve_batch(expand_paths(patterns), config, threads);
+    if (json)
+        write_json(std::cout, results);
+    else
+        write_csv(std::cout, results);
+
+    for (const auto &result : results)
+        if (!result.error.empty())
+            return 1;
+    return 0;
+}
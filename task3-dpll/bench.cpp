@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "bit_dpll.hpp"
+#include "cnf.hpp"
+#include "solver.hpp"
+
+
+// Benchmarks are run from the task directory, like the tests:
+//     ./task3_bench --benchmark_out=bench.json --benchmark_out_format=json
+// Every benchmark is repeated 5 times unless --benchmark_repetitions says otherwise,
+// the console shows the mean, median, stddev and cv, the JSON file also keeps the separate repetitions.
+
+struct Family {
+    std::string name;
+    std::string prefix; // path without the number and ".cnf"
+    int first, last;
+    bool is_sat;
+};
+
+static const std::vector<Family> FAMILIES = {
+    {"uf50", "data/uf50/uf50-0", 1, 100, true},
+    {"uuf50", "data/uuf50/uuf50-0", 1, 100, false},
+    {"pigeon", "data/pigeon-hole/hole", 6, 8, false},
+    {"hanoi", "data/hanoi/hanoi", 4, 4, true},
+};
+
+static std::string file_path(const Family &family, int i) {
+    return family.prefix + std::to_string(i) + ".cnf";
+}
+
+static const std::vector<CNF>& load(const Family &family) {
+    // the formulas are parsed once, outside of the measured loops
+    static std::map<std::string, std::vector<CNF>> loaded;
+    auto found = loaded.find(family.name);
+    if (found != loaded.end())
+        return found->second;
+
+    std::vector<CNF> formulas;
+    for (int i = family.first; i <= family.last; i++)
+        formulas.emplace_back(file_path(family, i));
+    return loaded.emplace(family.name, std::move(formulas)).first->second;
+}
+
+
+static int64_t family_bytes(const Family &family) {
+    int64_t bytes = 0;
+    for (int i = family.first; i <= family.last; i++) {
+        std::ifstream fin(file_path(family, i), std::ios::ate);
+        bytes += fin.tellg();
+    }
+    return bytes;
+}
+
+static void parse_stream(benchmark::State &state, const Family &family) {
+    for (auto _ : state) {
+        for (int i = family.first; i <= family.last; i++) {
+            std::ifstream fin(file_path(family, i));
+            CNF cnf(fin);
+            benchmark::DoNotOptimize(cnf.num_clauses());
+        }
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * family_bytes(family));
+    state.SetItemsProcessed(int64_t(state.iterations()) * (family.last - family.first + 1));
+}
+
+static void parse_mapped(benchmark::State &state, const Family &family) {
+    for (auto _ : state) {
+        for (int i = family.first; i <= family.last; i++) {
+            CNF cnf(file_path(family, i));
+            benchmark::DoNotOptimize(cnf.num_clauses());
+        }
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * family_bytes(family));
+    state.SetItemsProcessed(int64_t(state.iterations()) * (family.last - family.first + 1));
+}
+
+static void propagation(benchmark::State &state, const Family &family) {
+    // propagations per second spent in propagate (in the whole search unless built with TASK3_STATS=2),
+    // without the preprocessor changing the formula
+    SolverConfig config;
+    config.preprocess = false;
+    const auto &formulas = load(family);
+    uint64_t propagations = 0;
+    double seconds = 0;
+    for (auto _ : state) {
+        for (const auto &cnf : formulas) {
+            Solver solver(cnf, config);
+            bool is_sat = solver.solve();
+            benchmark::DoNotOptimize(is_sat);
+            propagations += solver.stats().propagations;
+            seconds += Counter::DETAILED ? solver.stats().propagate_seconds : solver.stats().solve_seconds;
+        }
+    }
+    state.SetItemsProcessed(int64_t(propagations));
+    if (Counter::ENABLED and seconds > 0)
+        state.counters["propagate_rate"] = double(propagations) / seconds;
+}
+
+static void solve(benchmark::State &state, const Family &family, const SolverConfig &config) {
+    const auto &formulas = load(family);
+    SolverStats total;
+    for (auto _ : state) {
+        for (const auto &cnf : formulas) {
+            Solver solver(cnf, config);
+            if (solver.solve() != family.is_sat) {
+                state.SkipWithError("wrong answer");
+                return;
+            }
+            total.decisions += solver.stats().decisions;
+            total.conflicts += solver.stats().conflicts;
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * formulas.size()));
+    double runs = double(state.iterations() * formulas.size());
+    state.counters["decisions"] = double(total.decisions) / runs;
+    state.counters["conflicts"] = double(total.conflicts) / runs;
+}
+
+static void solve_bits(benchmark::State &state, const Family &family, BitDpll::Kernel kernel) {
+    // DPLL with the first unassigned variable and FALSE first, as the "dpll" configuration of solve
+    SolverConfig config;
+    config.algorithm = CNF::DPLL;
+    config.heuristic = Heuristic::FIRST_UNASSIGNED;
+    config.phase_saving = false;
+    const auto &formulas = load(family);
+    for (auto _ : state) {
+        for (const auto &cnf : formulas) {
+            BitDpll solver(cnf, config, kernel);
+            if (solver.solve() != family.is_sat) {
+                state.SkipWithError("wrong answer");
+                return;
+            }
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * formulas.size()));
+}
+
+
+int main(int argc, char **argv) {
+    // the defaults go before the given flags, so that the latter override them
+    std::vector<char *> args = {argv[0]};
+    std::string repetitions = "--benchmark_repetitions=5";
+    std::string aggregates = "--benchmark_display_aggregates_only=true";
+    args.push_back(repetitions.data());
+    args.push_back(aggregates.data());
+    args.insert(args.end(), argv + 1, argv + argc);
+    int args_num = int(args.size());
+
+    benchmark::AddCustomContext("stats", Counter::ENABLED ? "on" : "off");
+
+    for (const auto &family : FAMILIES) {
+        benchmark::RegisterBenchmark(("parse/stream/" + family.name).c_str(), parse_stream, family)
+            ->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("parse/mapped/" + family.name).c_str(), parse_mapped, family)
+            ->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("propagate/" + family.name).c_str(), propagation, family)
+            ->Unit(benchmark::kMillisecond);
+    }
+
+    std::vector<std::pair<std::string, SolverConfig>> configs(3);
+    configs[0].first = "cdcl";
+    configs[1].first = "cdcl_no_preprocess";
+    configs[1].second.preprocess = false;
+    configs[2].first = "dpll";
+    configs[2].second.algorithm = CNF::DPLL;
+    configs[2].second.heuristic = Heuristic::FIRST_UNASSIGNED;
+    configs[2].second.phase_saving = false; // the original solver
+    for (const auto &family : FAMILIES) {
+        for (const auto &[name, config] : configs) {
+            benchmark::RegisterBenchmark(("solve/" + family.name + "/" + name).c_str(), solve, family, config)
+                ->Unit(benchmark::kMillisecond);
+        }
+    }
+
+    std::vector<std::pair<std::string, BitDpll::Kernel>> kernels = {
+        {"scalar", BitDpll::SCALAR}, {"sse", BitDpll::SSE}, {"avx2", BitDpll::AVX2}};
+    for (const auto &family : FAMILIES) {
+        const auto &formulas = load(family);
+        if (!std::all_of(formulas.begin(), formulas.end(), BitDpll::fits))
+            continue;
+        for (const auto &[name, kernel] : kernels) {
+            if (BitDpll::supported(kernel))
+                benchmark::RegisterBenchmark(("solve/" + family.name + "/dpll_bits_" + name).c_str(),
+                                             solve_bits, family, kernel)->Unit(benchmark::kMillisecond);
+        }
+    }
+
+    benchmark::Initialize(&args_num, args.data());
+    if (benchmark::ReportUnrecognizedArguments(args_num, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
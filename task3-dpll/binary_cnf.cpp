@@ -0,0 +1,26 @@
+#include <cstring>
+#include <initializer_list>
+#include "binary_cnf.hpp"
+
+
+bool is_binary_cnf(const char *begin, const char *end) {
+    return size_t(end - begin) >= sizeof(BinaryHeader::MAGIC)
+           and memcmp(begin, BinaryHeader::MAGIC, sizeof(BinaryHeader::MAGIC)) == 0;
+}
+
+uint64_t binary_checksum(const BinaryHeader &header, const int32_t *literals) {
+    // FNV-1a over whole words instead of bytes, four times fewer multiplications
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&hash](uint32_t word) {
+        hash ^= word;
+        hash *= 1099511628211ull;
+    };
+    add(header.version);
+    for (uint64_t field : {header.var_num, header.clause_num, header.literal_num}) {
+        add(uint32_t(field));
+        add(uint32_t(field >> 32));
+    }
+    for (size_t i = 0; i < header.literal_num; i++)
+        add(uint32_t(literals[i]));
+    return hash;
+}
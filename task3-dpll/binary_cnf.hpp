@@ -0,0 +1,27 @@
+#ifndef TASK3_BINARY_CNF_HPP
+#define TASK3_BINARY_CNF_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+// Binary CNF cache, in the byte order of the machine that wrote it:
+// the header below, then literal_num 32-bit literals, every clause terminated by 0.
+// CNF(path) recognizes the magic and takes the clauses without any parsing,
+// CNF::write_binary writes it (task3_convert for the files).
+struct BinaryHeader {
+    static constexpr char MAGIC[4] = {'C', 'N', 'F', 'B'};
+    static constexpr uint32_t VERSION = 2; // 1 had the checksum of the literals only
+
+    char magic[4];
+    uint32_t version;
+    uint64_t var_num;
+    uint64_t clause_num;
+    uint64_t literal_num; // the terminating zeros included
+    uint64_t checksum;    // binary_checksum of the fields above and the literals
+};
+
+[[nodiscard]] bool is_binary_cnf(const char *begin, const char *end); // starts with the magic
+[[nodiscard]] uint64_t binary_checksum(const BinaryHeader &header, const int32_t *literals);
+
+#endif //TASK3_BINARY_CNF_HPP
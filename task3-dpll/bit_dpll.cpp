@@ -0,0 +1,284 @@
+#include <stdexcept>
+#include "bit_dpll.hpp"
+
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+#define TASK3_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define TASK3_X86_KERNELS 0
+#endif
+
+
+// A clause is satisfied if one of its literals is true, false if none of its variables is free
+// and unit if exactly one of them is, i.e. free & (free - 1) == 0 for a nonzero free.
+
+static BitDpll::Scan scan_scalar(const uint64_t *positive, const uint64_t *negative, size_t size,
+                                 uint64_t true_vars, uint64_t false_vars) {
+    // written without branches, the same way as the vector kernels below
+    uint64_t unassigned = ~(true_vars | false_vars);
+    BitDpll::Scan scan = {0, 0, 0};
+    for (size_t i = 0; i < size; i++) {
+        uint64_t literals = positive[i] | negative[i];
+        uint64_t free = literals & unassigned;
+        uint64_t open = -uint64_t(((positive[i] & true_vars) | (negative[i] & false_vars)) == 0);
+        uint64_t single = -uint64_t((free & (free - 1)) == 0);
+        scan.conflict |= open & -uint64_t(free == 0) & literals;
+        uint64_t unit = open & single & free;
+        scan.implied_true |= unit & positive[i];
+        scan.implied_false |= unit & negative[i];
+    }
+    return scan;
+}
+
+#if TASK3_X86_KERNELS
+
+// lanes of the not satisfied clauses contribute their variables to the conflict
+// if nothing is free and their only free variable otherwise
+
+__attribute__((target("sse4.1")))
+static BitDpll::Scan scan_sse(const uint64_t *positive, const uint64_t *negative, size_t size,
+                              uint64_t true_vars, uint64_t false_vars) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi64x(1);
+    const __m128i t = _mm_set1_epi64x(int64_t(true_vars));
+    const __m128i f = _mm_set1_epi64x(int64_t(false_vars));
+    const __m128i unassigned = _mm_set1_epi64x(int64_t(~(true_vars | false_vars)));
+    __m128i implied_true = zero, implied_false = zero, conflict = zero;
+
+    for (size_t i = 0; i < size; i += 2) {
+        __m128i pos = _mm_loadu_si128(reinterpret_cast<const __m128i *>(positive + i));
+        __m128i neg = _mm_loadu_si128(reinterpret_cast<const __m128i *>(negative + i));
+        __m128i literals = _mm_or_si128(pos, neg);
+        __m128i free = _mm_and_si128(literals, unassigned);
+        __m128i open = _mm_cmpeq_epi64(_mm_or_si128(_mm_and_si128(pos, t), _mm_and_si128(neg, f)), zero);
+        __m128i none_free = _mm_cmpeq_epi64(free, zero);
+        __m128i single = _mm_cmpeq_epi64(_mm_and_si128(free, _mm_sub_epi64(free, one)), zero);
+        conflict = _mm_or_si128(conflict, _mm_and_si128(_mm_and_si128(open, none_free), literals));
+        __m128i unit = _mm_and_si128(_mm_and_si128(open, single), free);
+        implied_true = _mm_or_si128(implied_true, _mm_and_si128(unit, pos));
+        implied_false = _mm_or_si128(implied_false, _mm_and_si128(unit, neg));
+    }
+
+    uint64_t lanes[3][2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes[0]), implied_true);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes[1]), implied_false);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes[2]), conflict);
+    return {lanes[0][0] | lanes[0][1], lanes[1][0] | lanes[1][1], lanes[2][0] | lanes[2][1]};
+}
+
+__attribute__((target("avx2")))
+static BitDpll::Scan scan_avx2(const uint64_t *positive, const uint64_t *negative, size_t size,
+                               uint64_t true_vars, uint64_t false_vars) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i t = _mm256_set1_epi64x(int64_t(true_vars));
+    const __m256i f = _mm256_set1_epi64x(int64_t(false_vars));
+    const __m256i unassigned = _mm256_set1_epi64x(int64_t(~(true_vars | false_vars)));
+    __m256i implied_true = zero, implied_false = zero, conflict = zero;
+
+    for (size_t i = 0; i < size; i += 4) {
+        __m256i pos = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(positive + i));
+        __m256i neg = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(negative + i));
+        __m256i literals = _mm256_or_si256(pos, neg);
+        __m256i free = _mm256_and_si256(literals, unassigned);
+        __m256i open = _mm256_cmpeq_epi64(_mm256_or_si256(_mm256_and_si256(pos, t), _mm256_and_si256(neg, f)), zero);
+        __m256i none_free = _mm256_cmpeq_epi64(free, zero);
+        __m256i single = _mm256_cmpeq_epi64(_mm256_and_si256(free, _mm256_sub_epi64(free, one)), zero);
+        conflict = _mm256_or_si256(conflict, _mm256_and_si256(_mm256_and_si256(open, none_free), literals));
+        __m256i unit = _mm256_and_si256(_mm256_and_si256(open, single), free);
+        implied_true = _mm256_or_si256(implied_true, _mm256_and_si256(unit, pos));
+        implied_false = _mm256_or_si256(implied_false, _mm256_and_si256(unit, neg));
+    }
+
+    uint64_t lanes[3][4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes[0]), implied_true);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes[1]), implied_false);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes[2]), conflict);
+    BitDpll::Scan scan = {0, 0, 0};
+    for (size_t lane = 0; lane < 4; lane++) {
+        scan.implied_true |= lanes[0][lane];
+        scan.implied_false |= lanes[1][lane];
+        scan.conflict |= lanes[2][lane];
+    }
+    return scan;
+}
+
+#endif
+
+
+bool BitDpll::supported(Kernel kernel) {
+    switch (kernel) {
+        case SCALAR:
+            return true;
+#if TASK3_X86_KERNELS
+        case SSE:
+            return __builtin_cpu_supports("sse4.1");
+        case AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+BitDpll::Kernel BitDpll::best_kernel() {
+    for (Kernel kernel : {AVX2, SSE})
+        if (supported(kernel))
+            return kernel;
+    return SCALAR;
+}
+
+
+BitDpll::BitDpll(const CNF &cnf, const SolverConfig &config, Kernel kernel):
+        config(config), scan(scan_scalar), var_num(cnf.num_vars()), empty_clause_found(false),
+        true_vars(0), false_vars(0), phases(0), activity(cnf.num_vars(), 0.0), increment(1.0), random(config.seed) {
+    if (!fits(cnf))
+        throw std::invalid_argument("BitDpll supports at most 64 variables");
+    if (!supported(kernel))
+        throw std::invalid_argument("The kernel is not supported by the processor");
+#if TASK3_X86_KERNELS
+    if (kernel == SSE)
+        scan = scan_sse;
+    else if (kernel == AVX2)
+        scan = scan_avx2;
+#endif
+    all_vars = var_num == MAX_VARS ? ~uint64_t(0) : (uint64_t(1) << var_num) - 1;
+    if (config.seed != 0)
+        phases = (uint64_t(random()) << 32 | random()) & all_vars;
+
+    positive.reserve(cnf.num_clauses() + 3);
+    negative.reserve(cnf.num_clauses() + 3);
+    for (auto clause : cnf.get_clauses()) {
+        uint64_t pos = 0, neg = 0;
+        for (int literal : clause) {
+            if (literal > 0)
+                pos |= uint64_t(1) << (literal - 1);
+            else
+                neg |= uint64_t(1) << (-literal - 1);
+        }
+        if (pos == 0 and neg == 0)
+            empty_clause_found = true;
+        if ((pos & neg) != 0)
+            continue; // tautologies are always true
+        positive.push_back(pos);
+        negative.push_back(neg);
+    }
+    // the copies change nothing but let the vector kernels skip the tail
+    while (!positive.empty() and positive.size() % 4 != 0) {
+        positive.push_back(positive[0]);
+        negative.push_back(negative[0]);
+    }
+}
+
+
+bool BitDpll::propagate() {
+    // every round assigns all literals implied by the previous one
+    while (true) {
+        Scan implied = scan(positive.data(), negative.data(), positive.size(), true_vars, false_vars);
+        uint64_t contradicting = implied.implied_true & implied.implied_false;
+        if (implied.conflict != 0 or contradicting != 0) {
+            bump(implied.conflict | contradicting);
+            return false;
+        }
+        uint64_t vars = implied.implied_true | implied.implied_false;
+        if (vars == 0)
+            return true;
+        statistics.propagations += __builtin_popcountll(vars);
+        true_vars |= implied.implied_true;
+        false_vars |= implied.implied_false;
+    }
+}
+
+bool BitDpll::roll_back() {
+    while (!levels.empty() and levels.back().flipped)
+        levels.pop_back();
+    if (levels.empty())
+        return false;
+
+    if (config.phase_saving) {
+        uint64_t assigned = true_vars | false_vars;
+        phases = (phases & ~assigned) | true_vars;
+    }
+    Level &level = levels.back();
+    true_vars = level.true_vars;
+    false_vars = level.false_vars;
+    level.decision = -level.decision;
+    level.flipped = true;
+    uint64_t bit = uint64_t(1) << (abs(level.decision) - 1);
+    (level.decision > 0 ? true_vars : false_vars) |= bit;
+    statistics.backtracks++;
+    return true;
+}
+
+void BitDpll::bump(uint64_t vars) {
+    if (config.heuristic != Heuristic::VSIDS)
+        return;
+    for (; vars != 0; vars &= vars - 1) {
+        size_t var = __builtin_ctzll(vars);
+        activity[var] += increment;
+        if (activity[var] > 1e100) {
+            for (auto &value : activity)
+                value *= 1e-100;
+            increment *= 1e-100;
+        }
+    }
+    increment /= 0.95;
+}
+
+size_t BitDpll::pick_branch_var(uint64_t unassigned) {
+    if (config.random_var_freq > 0 and std::uniform_real_distribution<>(0, 1)(random) < config.random_var_freq) {
+        size_t var = random() % var_num;
+        if ((unassigned >> var) & 1)
+            return var;
+    }
+    size_t best = __builtin_ctzll(unassigned);
+    if (config.heuristic == Heuristic::VSIDS) {
+        for (uint64_t vars = unassigned & (unassigned - 1); vars != 0; vars &= vars - 1) {
+            size_t var = __builtin_ctzll(vars);
+            if (activity[var] > activity[best])
+                best = var;
+        }
+    }
+    return best;
+}
+
+
+bool BitDpll::solve() {
+    ScopedTimer timer(statistics.solve_seconds);
+    if (empty_clause_found)
+        return false;
+    levels.clear();
+    true_vars = false_vars = 0;
+
+    while (true) {
+        bool consistent;
+        {
+            DetailedTimer propagate_timer(statistics.propagate_seconds);
+            consistent = propagate();
+        }
+        if (!consistent) {
+            statistics.conflicts++;
+            if (!roll_back())
+                return false;
+            continue;
+        }
+
+        uint64_t unassigned = all_vars & ~(true_vars | false_vars);
+        if (unassigned == 0)
+            return true;
+        size_t var = pick_branch_var(unassigned);
+        bool value = (phases >> var) & 1;
+
+        statistics.decisions++;
+        levels.push_back({true_vars, false_vars, value ? int(var + 1) : -int(var + 1), false});
+        statistics.max_level.raise_to(levels.size());
+        (value ? true_vars : false_vars) |= uint64_t(1) << var;
+    }
+}
+
+std::vector<bool> BitDpll::model() const {
+    std::vector<bool> values(var_num);
+    for (size_t var = 0; var < var_num; var++)
+        values[var] = (true_vars >> var) & 1;
+    return values;
+}
@@ -0,0 +1,75 @@
+#ifndef TASK3_BIT_DPLL_HPP
+#define TASK3_BIT_DPLL_HPP
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "cnf.hpp"
+#include "solver.hpp"
+
+
+// DPLL for formulas of at most 64 variables: the assignment is a pair of bitmasks
+// (true and false variables), every clause is a pair of bitmasks (positive and negative
+// literals), and unit propagation evaluates all clauses at once with SIMD kernels
+// instead of following watches; backtracking restores the two masks of the level
+class BitDpll {
+
+public:
+    static constexpr size_t MAX_VARS = 64;
+
+    enum Kernel {
+        SCALAR, // one clause per step, portable
+        SSE,    // two clauses per step, SSE4.1
+        AVX2,   // four clauses per step
+    };
+    [[nodiscard]] static bool supported(Kernel kernel); // whether the processor runs the kernel
+    [[nodiscard]] static Kernel best_kernel();
+    [[nodiscard]] static bool fits(const CNF &cnf) { return cnf.num_vars() <= MAX_VARS; }
+
+    // uses the heuristic, phase saving, seed and random_var_freq of the config
+    explicit BitDpll(const CNF &cnf, const SolverConfig &config = SolverConfig(), Kernel kernel = best_kernel());
+
+    [[nodiscard]] bool solve();
+    // satisfying assignment found by solve, model[var] is the value of the variable var + 1
+    [[nodiscard]] std::vector<bool> model() const;
+    [[nodiscard]] const SolverStats& stats() const { return statistics; }
+
+    // implications of all clauses at once under the given assignment
+    struct Scan {
+        uint64_t implied_true;  // variables of the unit clauses with a free positive literal
+        uint64_t implied_false; // the same for negative literals
+        uint64_t conflict;      // variables of the false clauses, 0 if there are none
+    };
+
+private:
+    using ScanKernel = Scan (*)(const uint64_t *positive, const uint64_t *negative, size_t size,
+                                uint64_t true_vars, uint64_t false_vars);
+
+    struct Level {
+        uint64_t true_vars, false_vars; // the assignment before the decision
+        int decision;
+        bool flipped;
+    };
+
+    SolverConfig config;
+    SolverStats statistics;
+    ScanKernel scan;
+    size_t var_num;
+    uint64_t all_vars;
+    bool empty_clause_found;
+    std::vector<uint64_t> positive, negative; // clauses, padded to a multiple of 4 with copies of the first one
+
+    uint64_t true_vars, false_vars;
+    uint64_t phases;                          // saved values, a set bit for TRUE
+    std::vector<Level> levels;
+    std::vector<double> activity;             // VSIDS over the conflict clauses, like DPLL in Solver
+    double increment;
+    std::mt19937 random;
+
+    [[nodiscard]] bool propagate(); // returns false on a conflict
+    [[nodiscard]] bool roll_back(); // flips the last not flipped decision, false if there is none
+    [[nodiscard]] size_t pick_branch_var(uint64_t unassigned);
+    void bump(uint64_t vars);
+};
+
+#endif //TASK3_BIT_DPLL_HPP
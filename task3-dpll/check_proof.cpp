@@ -0,0 +1,116 @@
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "checker.hpp"
+#include "solver.hpp"
+
+
+void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [--proof FILE] [--stats] [--progress SEC] FORMULA" << std::endl;
+    std::cerr << "           solve, print the model or check the proof, the statistics as JSON" << std::endl;
+    std::cerr << "       " << program << " --check PROOF FORMULA" << std::endl;
+    std::cerr << "           check a binary DRAT proof" << std::endl;
+}
+
+bool check_proof(const CNF &cnf, std::istream &proof) {
+    auto t_start = std::chrono::steady_clock::now();
+    DratChecker checker(cnf);
+    bool verified = checker.check(proof);
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - t_start;
+    if (verified)
+        std::cout << "c proof verified: " << checker.lemmas() << " lemmas, " << checker.deletions()
+                  << " deletions in " << seconds.count() << " sec" << std::endl;
+    else
+        std::cout << "c proof check failed: " << checker.error() << std::endl;
+    return verified;
+}
+
+int main(int argc, char **argv) {
+    std::string proof_path, check_path, formula_path;
+    SolverConfig config;
+    bool stats = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--proof") == 0 and i + 1 < argc) {
+            proof_path = argv[++i];
+        } else if (strcmp(argv[i], "--check") == 0 and i + 1 < argc) {
+            check_path = argv[++i];
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else if (strcmp(argv[i], "--progress") == 0 and i + 1 < argc) {
+            try {
+                config.progress_interval = std::stod(argv[++i]);
+            } catch (const std::exception &) { // not a number or out of range
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (argv[i][0] == '-' or !formula_path.empty()) {
+            usage(argv[0]);
+            return 2;
+        } else {
+            formula_path = argv[i];
+        }
+    }
+    if (formula_path.empty() or (!proof_path.empty() and !check_path.empty())) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::unique_ptr<CNF> formula;
+    try {
+        formula = std::make_unique<CNF>(formula_path);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+    const CNF &cnf = *formula;
+    if (!check_path.empty()) {
+        std::ifstream proof(check_path, std::ios::binary);
+        if (!proof) {
+            std::cerr << "Can not open " << check_path << std::endl;
+            return 2;
+        }
+        return check_proof(cnf, proof) ? 0 : 1;
+    }
+
+    // without a file the proof is kept in memory
+    std::stringstream memory;
+    bool is_sat;
+    std::vector<bool> model;
+    {
+        auto proof = proof_path.empty() ? std::make_unique<ProofWriter>(memory) : std::make_unique<ProofWriter>(proof_path);
+        Solver solver(cnf, config, proof.get());
+        is_sat = solver.solve();
+        if (is_sat)
+            model = solver.model();
+        if (stats) {
+            std::cout << "c stats ";
+            solver.stats().write_json(std::cout);
+            std::cout << std::endl;
+        }
+    }
+
+    if (is_sat) {
+        std::cout << "s SATISFIABLE" << std::endl << "v";
+        for (size_t var = 0; var < model.size(); var++)
+            std::cout << " " << (model[var] ? int(var + 1) : -int(var + 1));
+        std::cout << " 0" << std::endl;
+        bool verified = check_model(cnf, model);
+        std::cout << (verified ? "c model verified" : "c model check failed") << std::endl;
+        return verified ? 10 : 1;
+    }
+
+    std::cout << "s UNSATISFIABLE" << std::endl;
+    bool verified;
+    if (proof_path.empty()) {
+        verified = check_proof(cnf, memory);
+    } else {
+        std::ifstream proof(proof_path, std::ios::binary);
+        verified = check_proof(cnf, proof);
+    }
+    return verified ? 20 : 1;
+}
@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include "checker.hpp"
+
+
+bool check_model(const CNF &cnf, const std::vector<bool> &model) {
+    for (auto clause : cnf.get_clauses()) {
+        bool satisfied = false;
+        for (int literal : clause)
+            if (size_t(abs(literal)) <= model.size() and model[abs(literal) - 1] == (literal > 0))
+                satisfied = true;
+        if (!satisfied)
+            return false;
+    }
+    return true;
+}
+
+
+DratChecker::DratChecker(const CNF &cnf):
+        var_num(0), formula_var_num(cnf.num_vars()), inconsistent(false), qhead(0), lemma_num(0), deletion_num(0) {
+    resize(cnf.num_vars());
+    clauses.reserve(cnf.num_clauses(), cnf.get_clauses().used_bytes() / sizeof(int));
+    for (auto clause : cnf.get_clauses())
+        add_clause(std::vector<int>(clause.begin(), clause.end()));
+}
+
+void DratChecker::resize(size_t new_var_num) {
+    watches.resize(2 * new_var_num);
+    var_values.resize(new_var_num, BoolTernary::UNKNOWN);
+    reasons.resize(new_var_num, NO_CLAUSE);
+    marks.resize(2 * new_var_num, false);
+    var_num = new_var_num;
+}
+
+uint64_t DratChecker::hash(const std::vector<int> &clause) {
+    uint64_t sum = 0;
+    for (int literal : clause) {
+        // splitmix64 finalizer of every literal, summed up
+        uint64_t x = uint64_t(int64_t(literal)) + 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        sum += x ^ (x >> 31);
+    }
+    return sum;
+}
+
+CNF::BoolTernary DratChecker::get_value(int literal) const {
+    BoolTernary value = var_values[abs(literal) - 1];
+    if (literal > 0 or value == BoolTernary::UNKNOWN)
+        return value;
+    return value == BoolTernary::TRUE ? BoolTernary::FALSE : BoolTernary::TRUE;
+}
+
+
+void DratChecker::add_clause(const std::vector<int> &clause) {
+    std::vector<int> literals(clause);
+    std::sort(literals.begin(), literals.end());
+    literals.erase(std::unique(literals.begin(), literals.end()), literals.end());
+    for (int literal : literals)
+        if (std::binary_search(literals.begin(), literals.end(), -literal))
+            return;
+    if (literals.empty()) {
+        inconsistent = true;
+        return;
+    }
+
+    // literals that are not false at the top level are watched
+    std::stable_partition(literals.begin(), literals.end(), [this](int literal) {
+        return get_value(literal) != BoolTernary::FALSE;
+    });
+    ClauseRef ref = clauses.alloc(literals.data(), literals.size());
+    by_hash[hash(literals)].push_back(ref);
+    if (literals.size() > 1) {
+        watches[lit_index(literals[0])].push_back(ref);
+        watches[lit_index(literals[1])].push_back(ref);
+    }
+
+    BoolTernary value = get_value(literals[0]);
+    if (value == BoolTernary::FALSE) {
+        inconsistent = true;
+    } else if (value == BoolTernary::UNKNOWN and (literals.size() == 1 or get_value(literals[1]) == BoolTernary::FALSE)) {
+        assign(literals[0], ref);
+        if (!propagate())
+            inconsistent = true;
+    }
+}
+
+void DratChecker::remove_clause(const std::vector<int> &clause) {
+    std::vector<int> literals(clause);
+    std::sort(literals.begin(), literals.end());
+    literals.erase(std::unique(literals.begin(), literals.end()), literals.end());
+    auto found = by_hash.find(hash(literals));
+    if (found == by_hash.end())
+        return;
+
+    for (int literal : literals)
+        marks[lit_index(literal)] = true;
+    auto &refs = found->second;
+    for (size_t i = 0; i < refs.size(); i++) {
+        ConstClause candidate = std::as_const(clauses)[refs[i]];
+        if (candidate.size() != literals.size()
+                or !std::all_of(candidate.begin(), candidate.end(), [this](int literal) { return marks[lit_index(literal)]; }))
+            continue;
+
+        // the implied literal of a reason is always the first one
+        if (get_value(candidate[0]) != BoolTernary::TRUE or reasons[abs(candidate[0]) - 1] != refs[i]) {
+            clauses.free(refs[i]);
+            refs.erase(refs.begin() + ptrdiff_t(i));
+            deletion_num++;
+        }
+        break;
+    }
+    for (int literal : literals)
+        marks[lit_index(literal)] = false;
+}
+
+
+void DratChecker::assign(int literal, ClauseRef reason) {
+    var_values[abs(literal) - 1] = literal > 0 ? BoolTernary::TRUE : BoolTernary::FALSE;
+    reasons[abs(literal) - 1] = reason;
+    trail.push_back(literal);
+}
+
+bool DratChecker::propagate() {
+    while (qhead < trail.size()) {
+        int false_literal = -trail[qhead++];
+        auto &watch_list = watches[lit_index(false_literal)];
+
+        size_t i = 0, j = 0;
+        while (i < watch_list.size()) {
+            ClauseRef ref = watch_list[i++];
+            Clause clause = clauses[ref];
+            if (clause.deleted())
+                continue;
+            if (clause[0] == false_literal)
+                std::swap(clause[0], clause[1]);
+
+            if (get_value(clause[0]) == BoolTernary::TRUE) {
+                watch_list[j++] = ref;
+                continue;
+            }
+
+            bool moved = false;
+            for (size_t k = 2; k < clause.size() and !moved; k++) {
+                if (get_value(clause[k]) != BoolTernary::FALSE) {
+                    std::swap(clause[1], clause[k]);
+                    watches[lit_index(clause[1])].push_back(ref);
+                    moved = true;
+                }
+            }
+            if (moved)
+                continue;
+
+            watch_list[j++] = ref;
+            if (get_value(clause[0]) == BoolTernary::FALSE) {
+                while (i < watch_list.size())
+                    watch_list[j++] = watch_list[i++];
+                watch_list.resize(j);
+                return false;
+            }
+            assign(clause[0], ref);
+        }
+        watch_list.resize(j);
+    }
+    return true;
+}
+
+void DratChecker::backtrack(size_t trail_size) {
+    while (trail.size() > trail_size) {
+        var_values[abs(trail.back()) - 1] = BoolTernary::UNKNOWN;
+        reasons[abs(trail.back()) - 1] = NO_CLAUSE;
+        trail.pop_back();
+    }
+    qhead = trail_size;
+}
+
+
+bool DratChecker::is_rup(const std::vector<int> &clause) {
+    // assigning the negation of the clause must lead to a conflict by unit propagation
+    if (inconsistent)
+        return true;
+    size_t trail_size = trail.size();
+    for (int literal : clause) {
+        BoolTernary value = get_value(literal);
+        if (value == BoolTernary::TRUE) {
+            backtrack(trail_size);
+            return true;
+        }
+        if (value == BoolTernary::UNKNOWN)
+            assign(-literal, NO_CLAUSE);
+    }
+    bool conflict = !propagate();
+    backtrack(trail_size);
+    return conflict;
+}
+
+bool DratChecker::is_rat(const std::vector<int> &clause) {
+    // every resolvent on the first literal with the current clauses must be RUP
+    if (clause.empty())
+        return false;
+    int pivot = clause[0];
+    const ClauseArena &arena = clauses;
+    for (auto it = arena.begin(); it != arena.end(); ++it) {
+        ConstClause other = *it;
+        if (std::find(other.begin(), other.end(), -pivot) == other.end())
+            continue;
+
+        std::vector<int> resolvent(clause);
+        for (int literal : other)
+            if (literal != -pivot)
+                resolvent.push_back(literal);
+        if (!is_rup(resolvent))
+            return false;
+    }
+    return true;
+}
+
+
+bool DratChecker::check(std::istream &proof) {
+    std::string data((std::istreambuf_iterator<char>(proof)), std::istreambuf_iterator<char>());
+    size_t position = 0;
+    std::vector<int> clause;
+
+    while (!inconsistent and position < data.size()) {
+        char type = data[position++];
+        if (type != 'a' and type != 'd') {
+            message = "Unknown step at byte " + std::to_string(position - 1);
+            return false;
+        }
+
+        clause.clear();
+        bool unknown_var = false;
+        while (true) {
+            uint64_t value = 0;
+            unsigned shift = 0;
+            unsigned char byte;
+            do {
+                if (position == data.size() or shift > 28) {
+                    message = "Malformed literal at byte " + std::to_string(position);
+                    return false;
+                }
+                byte = data[position++];
+                value |= uint64_t(byte & 127) << shift;
+                shift += 7;
+            } while (byte & 128);
+
+            if (value == 0)
+                break;
+            // variable 0 and the bits a 32-bit literal does not have
+            if (value >> 1 == 0 or value > UINT32_MAX) {
+                message = "Malformed literal at byte " + std::to_string(position - 1);
+                return false;
+            }
+            int literal = int(value >> 1);
+            clause.push_back(value & 1 ? -literal : literal);
+            if (size_t(literal) <= var_num)
+                continue;
+            // the tables are sized by the variables, so a proof can not make them arbitrarily large;
+            // a deleted clause with a new variable was never added
+            if (type == 'd') {
+                unknown_var = true;
+            } else if (size_t(literal) <= formula_var_num + lemma_num + 1) {
+                resize(literal);
+            } else {
+                message = "Variable " + std::to_string(literal) + " is out of range at byte " + std::to_string(position);
+                return false;
+            }
+        }
+
+        if (type == 'd') {
+            if (!unknown_var)
+                remove_clause(clause);
+            continue;
+        }
+        lemma_num++;
+        if (!is_rup(clause) and !is_rat(clause)) {
+            message = "Lemma " + std::to_string(lemma_num) + " is neither RUP nor RAT";
+            return false;
+        }
+        add_clause(clause);
+    }
+
+    if (!inconsistent)
+        message = "The proof does not derive the empty clause";
+    return inconsistent;
+}
@@ -0,0 +1,66 @@
+#ifndef TASK3_CHECKER_HPP
+#define TASK3_CHECKER_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "clause_arena.hpp"
+#include "cnf.hpp"
+
+
+// whether the assignment satisfies every clause, model[var] is the value of the variable var + 1
+[[nodiscard]] bool check_model(const CNF &cnf, const std::vector<bool> &model);
+
+
+// Forward checker of binary DRAT proofs: every lemma must be a reverse unit propagation
+// consequence of the current clauses or a resolution asymmetric tautology on its first
+// literal, and the empty clause must be derived in the end. Like drat-trim, the checker
+// ignores deletions of the clauses that are reasons of the top-level assignments.
+class DratChecker {
+
+public:
+    explicit DratChecker(const CNF &cnf);
+
+    [[nodiscard]] bool check(std::istream &proof); // the checker can check only one proof
+    [[nodiscard]] const std::string& error() const { return message; } // why the check failed
+
+    [[nodiscard]] uint64_t lemmas() const { return lemma_num; }
+    [[nodiscard]] uint64_t deletions() const { return deletion_num; }
+
+private:
+    using BoolTernary = CNF::BoolTernary;
+    static constexpr ClauseRef NO_CLAUSE = ClauseArena::NO_CLAUSE;
+
+    size_t var_num;
+    size_t formula_var_num;                      // a lemma may add one more, the pivot of extended resolution
+    bool inconsistent;                           // top-level propagation found a conflict
+    ClauseArena clauses;
+    std::vector<std::vector<ClauseRef>> watches; // indexed by lit_index
+    std::vector<BoolTernary> var_values;
+    std::vector<ClauseRef> reasons;
+    std::vector<int> trail;
+    size_t qhead;
+    std::unordered_map<uint64_t, std::vector<ClauseRef>> by_hash; // clauses by the hash of their literal set
+    std::vector<bool> marks;                     // indexed by lit_index
+    uint64_t lemma_num, deletion_num;
+    std::string message;
+
+    static size_t lit_index(int literal) { return 2 * (abs(literal) - 1) + (literal < 0); }
+    static uint64_t hash(const std::vector<int> &clause); // does not depend on the order of literals
+    [[nodiscard]] BoolTernary get_value(int literal) const;
+
+    void resize(size_t new_var_num);
+    void add_clause(const std::vector<int> &clause);
+    void remove_clause(const std::vector<int> &clause);
+    void assign(int literal, ClauseRef reason);
+    [[nodiscard]] bool propagate(); // false on conflict
+    void backtrack(size_t trail_size);
+
+    [[nodiscard]] bool is_rup(const std::vector<int> &clause);
+    [[nodiscard]] bool is_rat(const std::vector<int> &clause);
+};
+
+#endif //TASK3_CHECKER_HPP
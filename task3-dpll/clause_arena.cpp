@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <stdexcept>
+#include "clause_arena.hpp"
+
+
+ClauseRef Relocation::operator ()(ClauseRef ref) const {
+    auto it = std::lower_bound(old_refs.begin(), old_refs.end(), ref);
+    if (it == old_refs.end() or *it != ref)
+        return ClauseArena::NO_CLAUSE;
+    return new_refs[it - old_refs.begin()];
+}
+
+
+ClauseRef ClauseArena::alloc(const int *literals, size_t size, bool learnt) {
+    if (size > Clause::SIZE_MASK or memory.size() + Clause::HEADER_WORDS + size >= NO_CLAUSE)
+        throw std::length_error("Clause arena is full");
+
+    auto ref = ClauseRef(memory.size());
+    memory.push_back(uint32_t(size) | (learnt ? Clause::LEARNT : 0));
+    memory.push_back(0);
+    memory.push_back(0);
+    for (size_t i = 0; i < size; i++)
+        memory.push_back(uint32_t(literals[i]));
+    return ref;
+}
+
+void ClauseArena::free(ClauseRef ref) {
+    Clause clause = (*this)[ref];
+    if (clause.deleted())
+        return;
+    clause.data[0] |= Clause::DELETED;
+    wasted += Clause::HEADER_WORDS + clause.size();
+}
+
+Relocation ClauseArena::compact() {
+    // clauses only move towards the beginning, so a single forward pass is enough
+    Relocation relocation;
+    ClauseRef target = 0;
+    for (ClauseRef ref = 0; ref < memory.size();) {
+        size_t words = Clause::HEADER_WORDS + (*this)[ref].size();
+        if (!(*this)[ref].deleted()) {
+            relocation.old_refs.push_back(ref);
+            relocation.new_refs.push_back(target);
+            if (target != ref)
+                std::copy(memory.begin() + ref, memory.begin() + ref + words, memory.begin() + target);
+            target += words;
+        }
+        ref += words;
+    }
+    memory.resize(target);
+    wasted = 0;
+    return relocation;
+}
@@ -0,0 +1,126 @@
+#ifndef TASK3_CLAUSE_ARENA_HPP
+#define TASK3_CLAUSE_ARENA_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+
+using ClauseRef = uint32_t; // offset of a clause header in the arena memory
+
+
+// Clause stored in the arena: a header of HEADER_WORDS words followed by its literals.
+// The view does not own anything and stays valid until the next allocation in the arena.
+template <typename Word>
+class ClauseView {
+
+public:
+    using Literal = std::conditional_t<std::is_const_v<Word>, const int, int>;
+
+    static constexpr size_t HEADER_WORDS = 3;
+
+    explicit ClauseView(Word *data): data(data) {}
+
+    [[nodiscard]] size_t size() const { return data[0] & SIZE_MASK; }
+    [[nodiscard]] bool learnt() const { return data[0] & LEARNT; }
+    [[nodiscard]] bool deleted() const { return data[0] & DELETED; }
+    [[nodiscard]] bool used() const { return data[0] & USED; } // took part in a conflict since the flag was cleared
+    [[nodiscard]] uint32_t lbd() const { return data[1]; }
+    [[nodiscard]] float activity() const {
+        float value;
+        memcpy(&value, data + 2, sizeof(value));
+        return value;
+    }
+
+    void set_lbd(uint32_t lbd) { data[1] = lbd; }
+    void set_used(bool used) { data[0] = used ? data[0] | USED : data[0] & ~USED; }
+    void set_activity(float value) { memcpy(data + 2, &value, sizeof(value)); }
+
+    Literal* begin() const { return reinterpret_cast<Literal *>(data + HEADER_WORDS); }
+    Literal* end() const { return begin() + size(); }
+    Literal& operator [](size_t i) const { return begin()[i]; }
+
+private:
+    friend class ClauseArena;
+
+    static constexpr uint32_t SIZE_MASK = (1u << 29) - 1;
+    static constexpr uint32_t LEARNT = 1u << 29;
+    static constexpr uint32_t DELETED = 1u << 30;
+    static constexpr uint32_t USED = 1u << 31;
+
+    Word *data;
+};
+
+using Clause = ClauseView<uint32_t>;
+using ConstClause = ClauseView<const uint32_t>;
+
+
+// Maps the references of the clauses that survived a compaction to their new places
+class Relocation {
+
+public:
+    [[nodiscard]] ClauseRef operator ()(ClauseRef ref) const; // NO_CLAUSE for deleted clauses
+
+private:
+    friend class ClauseArena;
+
+    std::vector<ClauseRef> old_refs;
+    std::vector<ClauseRef> new_refs;
+};
+
+
+// All clauses of a formula in one contiguous buffer addressed by 32-bit offsets
+class ClauseArena {
+
+public:
+    static constexpr ClauseRef NO_CLAUSE = UINT32_MAX;
+
+    class const_iterator {
+
+    public:
+        const_iterator(const ClauseArena &arena, ClauseRef ref): arena(arena), ref(ref) { skip_deleted(); }
+
+        ConstClause operator *() const { return arena[ref]; }
+        [[nodiscard]] ClauseRef get_ref() const { return ref; }
+        const_iterator& operator ++() {
+            ref = arena.next(ref);
+            skip_deleted();
+            return *this;
+        }
+        bool operator !=(const const_iterator &rhs) const { return ref != rhs.ref; }
+
+    private:
+        const ClauseArena &arena;
+        ClauseRef ref;
+
+        void skip_deleted() {
+            while (ref < arena.memory.size() and arena[ref].deleted())
+                ref = arena.next(ref);
+        }
+    };
+
+    ClauseRef alloc(const int *literals, size_t size, bool learnt = false);
+    void free(ClauseRef ref); // marks the clause as deleted, its memory is reclaimed by compact
+    Relocation compact();     // moves the live clauses to the front of the buffer in place
+
+    Clause operator [](ClauseRef ref) { return Clause(memory.data() + ref); }
+    ConstClause operator [](ClauseRef ref) const { return ConstClause(memory.data() + ref); }
+    bool operator ==(const ClauseArena &rhs) const { return memory == rhs.memory; }
+
+    [[nodiscard]] const_iterator begin() const { return {*this, 0}; }
+    [[nodiscard]] const_iterator end() const { return {*this, ClauseRef(memory.size())}; }
+
+    void reserve(size_t clauses, size_t literals) { memory.reserve(clauses * Clause::HEADER_WORDS + literals); }
+    [[nodiscard]] size_t memory_bytes() const { return memory.capacity() * sizeof(uint32_t); }
+    [[nodiscard]] size_t wasted_bytes() const { return wasted * sizeof(uint32_t); }
+    [[nodiscard]] size_t used_bytes() const { return memory.size() * sizeof(uint32_t); }
+
+private:
+    std::vector<uint32_t> memory;
+    size_t wasted = 0; // words taken by deleted clauses
+
+    [[nodiscard]] ClauseRef next(ClauseRef ref) const { return ref + Clause::HEADER_WORDS + (*this)[ref].size(); }
+};
+
+#endif //TASK3_CLAUSE_ARENA_HPP
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include "clause_exchange.hpp"
+
+
+void ClauseExchange::publish(size_t producer, const std::vector<int> &clause) {
+    if (clause.size() > MAX_SIZE)
+        return;
+
+    uint64_t position = head.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots[position % SLOTS];
+
+    // a slot still written by a writer from the previous lap is left alone
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    if (sequence % 2 == 1 or sequence >= 2 * position + 2)
+        return;
+    if (!slot.sequence.compare_exchange_strong(sequence, 2 * position + 1, std::memory_order_relaxed))
+        return;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.producer.store(uint32_t(producer), std::memory_order_relaxed);
+    slot.size.store(uint32_t(clause.size()), std::memory_order_relaxed);
+    for (size_t i = 0; i < clause.size(); i++)
+        slot.literals[i].store(clause[i], std::memory_order_relaxed);
+
+    slot.sequence.store(2 * position + 2, std::memory_order_release);
+}
+
+void ClauseExchange::collect(size_t consumer, uint64_t &cursor, std::vector<std::vector<int>> &clauses) const {
+    uint64_t end = head.load(std::memory_order_acquire);
+    if (end - cursor > SLOTS)
+        cursor = end - SLOTS;
+
+    for (; cursor < end; cursor++) {
+        const Slot &slot = slots[cursor % SLOTS];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence < 2 * cursor + 2)
+            break; // not written yet, try again next time
+        if (sequence != 2 * cursor + 2)
+            continue; // already overwritten
+
+        size_t producer = slot.producer.load(std::memory_order_relaxed);
+        size_t size = std::min<size_t>(slot.size.load(std::memory_order_relaxed), MAX_SIZE);
+        std::vector<int> clause(size);
+        for (size_t i = 0; i < size; i++)
+            clause[i] = slot.literals[i].load(std::memory_order_relaxed);
+
+        // the copy is only valid if no writer touched the slot meanwhile
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence or producer == consumer)
+            continue;
+        clauses.push_back(std::move(clause));
+    }
+}
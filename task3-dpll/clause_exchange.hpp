@@ -0,0 +1,36 @@
+#ifndef TASK3_CLAUSE_EXCHANGE_HPP
+#define TASK3_CLAUSE_EXCHANGE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+
+// Lock-free ring buffer through which parallel solvers share short learned clauses.
+// Every slot is guarded by a sequence number: odd while a clause is being written,
+// 2 * position + 2 once the clause published at that position is complete.
+// Sharing is best effort, a clause may be dropped or overwritten before everybody reads it.
+class ClauseExchange {
+
+public:
+    static constexpr size_t MAX_SIZE = 8;  // longer clauses are not shared
+    static constexpr size_t SLOTS = 1024;
+
+    void publish(size_t producer, const std::vector<int> &clause);
+    // appends the clauses published by other producers since cursor and advances cursor
+    void collect(size_t consumer, uint64_t &cursor, std::vector<std::vector<int>> &clauses) const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint32_t> producer{0};
+        std::atomic<uint32_t> size{0};
+        std::array<std::atomic<int>, MAX_SIZE> literals{};
+    };
+
+    std::array<Slot, SLOTS> slots;
+    std::atomic<uint64_t> head{0};
+};
+
+#endif //TASK3_CLAUSE_EXCHANGE_HPP
@@ -1,10 +1,23 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <sstream>
-#include <stack>
+#include <utility>
+#include "binary_cnf.hpp"
+#include "bit_dpll.hpp"
 #include "cnf.hpp"
+#include "dimacs.hpp"
+#include "input_stream.hpp"
+#include "local_search.hpp"
+#include "solver.hpp"
 
 
 CNF::CNF(std::istream &fin) {
     std::string line;
+    std::vector<int> clause;
+    size_t clauses_read = 0;
     var_num = 0;
     clause_num = 0;
 
@@ -16,21 +29,153 @@ CNF::CNF(std::istream &fin) {
             std::string tmp;
             std::stringstream ss(line);
             ss >> tmp >> tmp >> var_num >> clause_num;
-            clauses.reserve(clause_num);
+            clauses.reserve(clause_num, 3 * clause_num);
             continue;
         }
 
         std::stringstream ss(line);
-        std::vector<int> clause;
         int variable;
-        while (ss >> variable and variable != 0)
+        clause.clear();
+        while (ss >> variable and variable != 0) {
+            if (variable < -int64_t(var_num) or variable > int64_t(var_num))
+                throw std::invalid_argument("Invalid DIMACS: variable is out of range");
             clause.push_back(variable);
-        clauses.push_back(clause);
+        }
+        clauses.alloc(clause.data(), clause.size());
+        clauses_read++;
+    }
+
+    if (clauses_read != clause_num)
+        throw std::invalid_argument("Invalid number of clauses");
+
+}
+
+static constexpr size_t MAPPED_SLICE = 1 << 20;
+
+// moves the clauses terminated by 0 to the arena, the literals of an unfinished one are kept
+static void move_clauses(std::vector<int> &literals, ClauseArena &clauses) {
+    const int *begin = literals.data();
+    for (const int *it = begin; it != literals.data() + literals.size(); it++) {
+        if (*it == 0) {
+            clauses.alloc(begin, it - begin);
+            begin = it + 1;
+        }
+    }
+    literals.erase(literals.begin(), literals.begin() + (begin - literals.data()));
+}
+
+CNF::CNF(const std::string &path) {
+    MappedFile file(path);
+    if (!file.is_mapped() or InputStream::detect(file.begin(), file.end()) != InputStream::PLAIN) {
+        // pipes, empty or special files can not be mapped, compressed ones have to be decoded
+        read_chunks(*InputStream::open(path));
+        return;
+    }
+    if (is_binary_cnf(file.begin(), file.end())) {
+        read_binary(file.begin(), file.end());
+        return;
+    }
+
+    // the mapping is scanned in slices and the finished clauses go to the arena after each one,
+    // so the literals are not held twice
+    auto t_start = std::chrono::steady_clock::now();
+    DimacsData data;
+    DimacsParser parser(data);
+    for (const char *slice = file.begin(); slice != file.end();) {
+        const char *slice_end = slice + std::min(MAPPED_SLICE, size_t(file.end() - slice));
+        parser.feed(slice, slice_end);
+        if (slice == file.begin()) {
+            // the first slice predicts the size of the arena, the header is not trusted with it
+            double scale = double(file.bytes()) / double(slice_end - slice);
+            clauses.reserve(size_t(double(data.clauses_read) * scale), size_t(double(data.literals.size()) * scale));
+        }
+        move_clauses(data.literals, clauses);
+        slice = slice_end;
     }
+    parser.finish();
+    move_clauses(data.literals, clauses);
+    if (data.clauses_read != data.clause_num)
+        throw std::invalid_argument("Invalid number of clauses");
+
+    var_num = data.var_num;
+    clause_num = data.clause_num;
+
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - t_start;
+    throughput = double(file.bytes()) / (1024 * 1024) / seconds.count();
+}
+
+void CNF::read_chunks(InputStream &input) {
+    // the clauses are moved to the arena after every chunk, so besides the formula
+    // only one chunk of the text and the unfinished clause are kept
+    auto t_start = std::chrono::steady_clock::now();
+    DimacsData data;
+    DimacsParser parser(data);
+    std::vector<char> chunk(1 << 20);
+    size_t bytes = 0;
+    while (size_t size = input.read(chunk.data(), chunk.size())) {
+        parser.feed(chunk.data(), chunk.data() + size);
+        move_clauses(data.literals, clauses);
+        bytes += size;
+    }
+    parser.finish();
+    move_clauses(data.literals, clauses);
+    if (data.clauses_read != data.clause_num)
+        throw std::invalid_argument("Invalid number of clauses");
+
+    var_num = data.var_num;
+    clause_num = data.clause_num;
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - t_start;
+    throughput = double(bytes) / (1024 * 1024) / seconds.count();
+}
 
-    if (clauses.size() != clause_num)
+void CNF::read_binary(const char *begin, const char *end) {
+    auto t_start = std::chrono::steady_clock::now();
+    BinaryHeader header{};
+    if (size_t(end - begin) < sizeof(header))
+        throw std::invalid_argument("Invalid binary CNF: the header is cut");
+    memcpy(&header, begin, sizeof(header));
+    if (header.version != BinaryHeader::VERSION)
+        throw std::invalid_argument("Unsupported binary CNF version " + std::to_string(header.version));
+    size_t body = size_t(end - begin) - sizeof(header);
+    if (body % sizeof(int32_t) != 0 or header.literal_num != body / sizeof(int32_t))
+        throw std::invalid_argument("Invalid binary CNF: wrong size");
+    if (header.clause_num > header.literal_num)
+        throw std::invalid_argument("Invalid number of clauses");
+    // the solvers size their tables by it and the literals are ints
+    if (header.var_num > uint64_t(INT32_MAX))
+        throw std::invalid_argument("Invalid binary CNF: too many variables");
+
+    // the mapping is page aligned and the header takes a multiple of 4 bytes
+    const auto *literals = reinterpret_cast<const int32_t *>(begin + sizeof(header));
+    if (binary_checksum(header, literals) != header.checksum)
+        throw std::invalid_argument("Invalid binary CNF: wrong checksum");
+    if (header.literal_num > 0 and literals[header.literal_num - 1] != 0)
+        throw std::invalid_argument("Invalid binary CNF: the last clause is not terminated");
+
+    // the arena puts a header before every clause, so the clauses are copied, in one pass
+    var_num = header.var_num;
+    clause_num = 0;
+    clauses.reserve(header.clause_num, header.literal_num - header.clause_num);
+    const int32_t *clause = literals;
+    for (const int32_t *it = literals; it != literals + header.literal_num; it++) {
+        if (*it == 0) {
+            clauses.alloc(clause, it - clause);
+            clause = it + 1;
+            clause_num++;
+        } else if (*it < -int64_t(var_num) or *it > int64_t(var_num)) {
+            throw std::invalid_argument("Invalid binary CNF: variable is out of range");
+        }
+    }
+    if (clause_num != header.clause_num)
         throw std::invalid_argument("Invalid number of clauses");
 
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - t_start;
+    throughput = double(end - begin) / (1024 * 1024) / seconds.count();
+}
+
+CNF::CNF(size_t var_num, ClauseArena clauses): var_num(var_num), clause_num(0), clauses(std::move(clauses)) {
+    for (auto it = this->clauses.begin(); it != this->clauses.end(); ++it)
+        clause_num++;
 }
 
 std::ostream & operator<<(std::ostream &out, const CNF &cnf) {
@@ -39,15 +184,15 @@ std::ostream & operator<<(std::ostream &out, const CNF &cnf) {
     out << "Clauses:" << std::endl;
 
     bool separator = false;
-    for (size_t i = 0; i < cnf.clause_num; i++) {
+    for (auto clause : cnf.clauses) {
         if (separator)
             out << " &";
         else
             out << "  ";
         out << " (";
 
-        for (auto it = cnf.clauses[i].begin(); it != cnf.clauses[i].end(); it++) {
-            if (it != cnf.clauses[i].begin())
+        for (auto it = clause.begin(); it != clause.end(); it++) {
+            if (it != clause.begin())
                 out << " \\/ ";
             if (*it < 0)
                 out << "~x" << (-*it);
@@ -61,124 +206,67 @@ std::ostream & operator<<(std::ostream &out, const CNF &cnf) {
     return out;
 }
 
-
-CNF::BoolTernary get_value(int literal, std::vector<CNF::BoolTernary> &var_values) {
-    size_t index = abs(literal) - 1;
-    if (literal > 0 or var_values[index] == CNF::BoolTernary::UNKNOWN)
-        return var_values[index];
-    return var_values[index] == CNF::BoolTernary::TRUE ? CNF::BoolTernary::FALSE : CNF::BoolTernary::TRUE;
-}
-
-bool is_unit(const std::vector<int> &clause, std::vector<CNF::BoolTernary> &var_values) {
-    int cnt = 0;
-    for (auto it = clause.begin(); it != clause.end() and cnt < 2; it++)
-        if (get_value(*it, var_values) == CNF::BoolTernary::UNKNOWN)
-            cnt++;
-    return cnt == 1;
-}
-
-bool is_true(const std::vector<int> &clause, std::vector<CNF::BoolTernary> &var_values) {
-    for (auto it : clause)
-        if (get_value(it, var_values) == CNF::BoolTernary::TRUE)
-            return true;
-    return false;
+void CNF::write_dimacs(std::ostream &out) const {
+    out << "p cnf " << var_num << " " << clause_num << "\n";
+    for (auto clause : clauses) {
+        for (int literal : clause)
+            out << literal << " ";
+        out << "0\n";
+    }
 }
 
-bool is_false(const std::vector<int> &clause, std::vector<CNF::BoolTernary> &var_values) {
-    for (auto it : clause)
-        if (get_value(it, var_values) != CNF::BoolTernary::FALSE)
-            return false;
-    return true;
-}
+void CNF::write_binary(std::ostream &out) const {
+    std::vector<int32_t> literals;
+    literals.reserve(clauses.used_bytes() / sizeof(int32_t));
+    for (auto clause : clauses) {
+        literals.insert(literals.end(), clause.begin(), clause.end());
+        literals.push_back(0);
+    }
 
-int get_literal(const std::vector<int> &clause, std::vector<CNF::BoolTernary> &var_values) {
-    for (auto it : clause)
-        if (get_value(it, var_values) == CNF::BoolTernary::UNKNOWN)
-            return it;
-    throw std::invalid_argument("Clause is not unit");
+    BinaryHeader header{};
+    memcpy(header.magic, BinaryHeader::MAGIC, sizeof(header.magic));
+    header.version = BinaryHeader::VERSION;
+    header.var_num = var_num;
+    header.clause_num = clause_num;
+    header.literal_num = literals.size();
+    header.checksum = binary_checksum(header, literals.data());
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(literals.data()), std::streamsize(literals.size() * sizeof(int32_t)));
 }
 
 
-void CNF::unit_prop(std::stack<int> &assignments, std::vector<BoolTernary> &var_values) const {
-    bool unit_clause_found = true;
-
-    while (unit_clause_found) {
-        unit_clause_found = false;
-        for (const auto & clause : clauses) {
-            if (is_true(clause, var_values) or !is_unit(clause, var_values))
-                continue;
-
-            int literal = get_literal(clause, var_values);
-            BoolTernary value = literal > 0 ? BoolTernary::TRUE : BoolTernary ::FALSE;
-            var_values[abs(literal) - 1] = value;
-            assignments.push(literal);
-            unit_clause_found = true;
-        }
-    }
-}
-
-bool CNF::all_true_clauses(std::vector<BoolTernary> &var_values) const {
-    for (const auto & clause : clauses)
-        if (!is_true(clause, var_values))
-            return false;
-    return true;
+bool CNF::is_sat() const {
+    return is_sat(DPLL);
 }
 
-bool CNF::exists_false_clause(std::vector<BoolTernary> &var_values) const {
-    for (const auto & clause : clauses)
-        if (is_false(clause, var_values))
-            return true;
-    return false;
+bool CNF::is_sat(Algorithm algorithm) const {
+    SolverConfig config;
+    config.algorithm = algorithm;
+    return is_sat(config);
 }
 
-void CNF::roll_back(std::stack<int> &assignments, std::stack<std::pair<int, BoolTernary>> &decisions,
-        std::vector<BoolTernary> &var_values) const {
-    while (assignments.top() != decisions.top().first) {
-        var_values[abs(assignments.top()) - 1] = BoolTernary::UNKNOWN;
-        assignments.pop();
-    }
-
-    auto &decision = decisions.top();
-
-    if (decision.second == BoolTernary::FALSE) {
-        decision.second = BoolTernary::TRUE;
-        var_values[abs(decision.first) - 1] = BoolTernary::TRUE;
-    } else {
-        assignments.pop();
-        decisions.pop();
-        var_values[abs(decision.first) - 1] = BoolTernary::UNKNOWN;
-
-        if (!decisions.empty()) {
-            roll_back(assignments, decisions, var_values);
-        }
-    }
+bool CNF::is_sat(const SolverConfig &config) const {
+    if (config.local_search)
+        return solve_hybrid(*this, config);
+    if (config.algorithm == DPLL and config.bit_parallel and BitDpll::fits(*this))
+        return BitDpll(*this, config).solve();
+    Solver solver(*this, config);
+    return solver.solve();
 }
 
-
-bool CNF::is_sat() const {
-    std::stack<int> assignments;
-    std::stack<std::pair<int, BoolTernary>> decisions;
-    std::vector<BoolTernary> var_values;
-    var_values = std::vector<BoolTernary>(var_num, BoolTernary::UNKNOWN);
-
-    while (true) {
-        unit_prop(assignments, var_values);
-
-        if (exists_false_clause(var_values)) {
-            roll_back(assignments, decisions, var_values);
-            if (decisions.empty())
-                return false;
-            continue;
-        }
-
-        if (all_true_clauses(var_values))
-            return true;
-
-        int index = 0;
-        while (index < var_num and get_value(index + 1, var_values) != BoolTernary::UNKNOWN)
-            index++;
-        decisions.push(std::make_pair(index + 1, BoolTernary::FALSE));
-        assignments.push(index + 1);
-        var_values[index] = BoolTernary::FALSE;
+bool CNF::is_sat(const SolverConfig &config, std::vector<bool> &model) const {
+    if (config.local_search)
+        return solve_hybrid(*this, config, &model);
+    if (config.algorithm == DPLL and config.bit_parallel and BitDpll::fits(*this)) {
+        BitDpll solver(*this, config);
+        if (!solver.solve())
+            return false;
+        model = solver.model();
+        return true;
     }
+    Solver solver(*this, config);
+    if (!solver.solve())
+        return false;
+    model = solver.model();
+    return true;
 }
@@ -1,17 +1,44 @@
 #ifndef TASK3_CNF_HPP
 #define TASK3_CNF_HPP
 
-#include <set>
+#include <iostream>
 #include <vector>
-#include <stack>
+#include "clause_arena.hpp"
+
+struct SolverConfig;
+class InputStream;
 
 
 class CNF {
 
 public:
     explicit CNF(std::istream &fin); // reading CNF from a file in DIMACS format
-    [[nodiscard]] bool is_sat() const; // checking the satisfiability of a formula using DPLL algorithm
+    // mapping a DIMACS file into memory and scanning it in place; gzip and xz files and pipes
+    // are decompressed and scanned in chunks instead, without keeping the whole text;
+    // binary files written by write_binary are taken without parsing
+    explicit CNF(const std::string &path);
+    CNF(size_t var_num, ClauseArena clauses); // formula built in memory, e.g. by the preprocessor
     friend std::ostream& operator <<(std::ostream &out, const CNF &cnf);
+    void write_dimacs(std::ostream &out) const; // the formula in DIMACS format, readable by the constructors
+    void write_binary(std::ostream &out) const; // the binary cache format of binary_cnf.hpp
+
+    enum Algorithm {
+        DPLL, // chronological backtracking over the decisions
+        CDCL, // conflict-driven clause learning with non-chronological backjumping
+    };
+
+    // checking the satisfiability of a formula with DPLL (the default configuration otherwise),
+    // the chosen algorithm or the given configuration
+    [[nodiscard]] bool is_sat() const;
+    [[nodiscard]] bool is_sat(Algorithm algorithm) const;
+    [[nodiscard]] bool is_sat(const SolverConfig &config) const;
+    // the same, keeping the satisfying assignment: model[var] is the value of the variable var + 1
+    [[nodiscard]] bool is_sat(const SolverConfig &config, std::vector<bool> &model) const;
+
+    [[nodiscard]] size_t num_vars() const { return var_num; }
+    [[nodiscard]] size_t num_clauses() const { return clause_num; }
+    [[nodiscard]] const ClauseArena& get_clauses() const { return clauses; }
+    [[nodiscard]] double parse_throughput() const { return throughput; } // MB/s of the text read by the path constructor, 0 otherwise
 
     enum BoolTernary {
         TRUE,
@@ -21,13 +48,11 @@ public:
 
 private:
     size_t var_num, clause_num;
-    std::vector<std::vector<int>> clauses;
-    void unit_prop(std::stack<int> &assignments, std::vector<BoolTernary> &var_values) const;
-    [[nodiscard]] bool all_true_clauses(std::vector<BoolTernary> &var_values) const;
-    [[nodiscard]] bool exists_false_clause(std::vector<BoolTernary> &var_values) const;
-    void roll_back(std::stack<int> &assignments,
-                   std::stack<std::pair<int, BoolTernary>> &decisions,
-                   std::vector<BoolTernary> &var_values) const;
+    double throughput = 0;
+    ClauseArena clauses;
+
+    void read_chunks(InputStream &input);
+    void read_binary(const char *begin, const char *end);
 };
 
 #endif //TASK3_CNF_HPP
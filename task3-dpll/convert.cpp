@@ -0,0 +1,50 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "cnf.hpp"
+
+
+void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [-d] INPUT OUTPUT" << std::endl;
+    std::cerr << "           convert a formula (DIMACS, gzip, xz or binary) to the binary cache format," << std::endl;
+    std::cerr << "           or back to DIMACS with -d" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    bool dimacs = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0)
+            dimacs = true;
+        else
+            paths.emplace_back(argv[i]);
+    }
+    if (paths.size() != 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        CNF cnf(paths[0]);
+        std::ofstream fout(paths[1], std::ios::binary);
+        if (!fout) {
+            std::cerr << "Can not open " << paths[1] << std::endl;
+            return 2;
+        }
+        if (dimacs)
+            cnf.write_dimacs(fout);
+        else
+            cnf.write_binary(fout);
+        if (!fout.flush()) {
+            std::cerr << "Can not write " << paths[1] << std::endl;
+            return 2;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
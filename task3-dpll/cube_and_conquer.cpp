@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "cube_and_conquer.hpp"
+#include "thread_pool.hpp"
+
+
+CubeAndConquer::CubeAndConquer(const CNF &cnf, size_t workers, size_t depth, const SolverConfig &config):
+        cnf(cnf), config(config), workers(workers), depth(depth), refuted(0), occurrences(cnf.num_vars(), 0) {
+    if (this->workers == 0)
+        this->workers = std::max(1u, std::thread::hardware_concurrency());
+    if (this->depth == 0)
+        this->depth = size_t(std::ceil(std::log2(double(8 * this->workers))));
+    for (auto clause : cnf.get_clauses())
+        for (int literal : clause)
+            occurrences[abs(literal) - 1]++;
+}
+
+
+void CubeAndConquer::split(Solver &splitter, std::vector<int> cube, size_t level) {
+    std::vector<int> implied, positive, negative;
+    while (true) {
+        if (!splitter.lookahead(cube, implied)) {
+            refuted++;
+            return;
+        }
+        if (level == depth) {
+            cubes.push_back(cube);
+            return;
+        }
+
+        // the most frequent free variables are looked ahead in both directions; a variable
+        // that fails in one direction is added to the cube with the other value and the split is repeated
+        std::vector<bool> assigned(splitter.num_vars(), false);
+        for (int literal : implied)
+            assigned[abs(literal) - 1] = true;
+        const Preprocessor *preprocessor = splitter.get_preprocessor();
+        std::vector<size_t> candidates;
+        for (size_t var = 0; var < cnf.num_vars(); var++)
+            if (!assigned[var] and occurrences[var] > 0 and (preprocessor == nullptr or !preprocessor->is_eliminated(var)))
+                candidates.push_back(var);
+        if (candidates.empty()) {
+            cubes.push_back(cube); // everything is assigned, the solver will check the model
+            return;
+        }
+        size_t candidate_num = std::min(CANDIDATES, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + candidate_num, candidates.end(),
+                          [this](size_t a, size_t b) { return occurrences[a] > occurrences[b]; });
+        candidates.resize(candidate_num);
+
+        int best = 0, forced = 0;
+        size_t best_score = 0;
+        for (size_t var : candidates) {
+            int literal = int(var + 1);
+            cube.push_back(literal);
+            bool positive_ok = splitter.lookahead(cube, positive);
+            cube.back() = -literal;
+            bool negative_ok = splitter.lookahead(cube, negative);
+            cube.pop_back();
+
+            if (!positive_ok or !negative_ok) {
+                forced = positive_ok ? literal : -literal; // both failing refute the cube on the next lookahead
+                break;
+            }
+            // march-like product of the new assignments on both sides, the sum breaks ties
+            size_t a = positive.size() - implied.size(), b = negative.size() - implied.size();
+            size_t score = a * b * 1024 + a + b;
+            if (best == 0 or score > best_score) {
+                best = literal;
+                best_score = score;
+            }
+        }
+        if (forced != 0) {
+            cube.push_back(forced);
+            continue;
+        }
+
+        cube.push_back(best);
+        split(splitter, cube, level + 1);
+        cube.back() = -best;
+        split(splitter, cube, level + 1);
+        return;
+    }
+}
+
+
+bool CubeAndConquer::solve() {
+    cubes.clear();
+    refuted = 0;
+    values.clear();
+    {
+        Solver splitter(cnf, config);
+        split(splitter, {}, 0);
+    }
+
+    std::atomic<bool> stop(false);
+    std::mutex mutex;
+    bool is_sat = false;
+    std::exception_ptr error;
+    // a worker takes an idle solver, so that the clauses learned on one cube help with the next ones
+    std::vector<std::unique_ptr<Solver>> idle;
+    {
+        ThreadPool pool(workers);
+        for (const auto &cube : cubes) {
+            pool.submit([&, cube]() {
+                if (stop)
+                    return;
+                try {
+                    std::unique_ptr<Solver> solver;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!idle.empty()) {
+                            solver = std::move(idle.back());
+                            idle.pop_back();
+                        }
+                    }
+                    if (!solver)
+                        solver = std::make_unique<Solver>(cnf, config);
+
+                    CNF::BoolTernary answer = solver->solve(cube, stop);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (answer == CNF::BoolTernary::TRUE and !is_sat) {
+                        is_sat = true;
+                        values = solver->model();
+                        stop = true;
+                    } else if (answer == CNF::BoolTernary::FALSE and solver->failed_assumptions().empty()) {
+                        stop = true; // unsatisfiable without any cube
+                    }
+                    idle.push_back(std::move(solver));
+                } catch (...) {
+                    // the other cubes are not worth solving without this one
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    stop = true;
+                }
+            });
+        }
+        pool.wait();
+    }
+    if (error)
+        std::rethrow_exception(error);
+    return is_sat;
+}
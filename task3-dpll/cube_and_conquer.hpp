@@ -0,0 +1,44 @@
+#ifndef TASK3_CUBE_AND_CONQUER_HPP
+#define TASK3_CUBE_AND_CONQUER_HPP
+
+#include <vector>
+#include "cnf.hpp"
+#include "solver.hpp"
+
+
+// Splits the formula into cubes (conjunctions of literals covering the whole search space)
+// with a lookahead on the variables, then solves the formula under every cube as assumptions
+// in a pool of incremental solvers, one per worker. The formula is satisfiable if some cube is,
+// the first model cancels the other cubes.
+class CubeAndConquer {
+
+public:
+    // depth 0 - enough cubes for about 8 per worker; every solver, the splitter included,
+    // uses config, so the cubes only contain variables that its preprocessing keeps
+    explicit CubeAndConquer(const CNF &cnf, size_t workers = 0, size_t depth = 0,
+                            const SolverConfig &config = SolverConfig());
+
+    [[nodiscard]] bool solve();
+    // satisfying assignment found by solve, model[var] is the value of the variable var + 1
+    [[nodiscard]] const std::vector<bool>& model() const { return values; }
+
+    [[nodiscard]] const std::vector<std::vector<int>>& get_cubes() const { return cubes; } // made by solve
+    [[nodiscard]] size_t refuted_cubes() const { return refuted; } // dropped because the lookahead found a conflict
+
+private:
+    static constexpr size_t CANDIDATES = 64; // variables looked ahead at every split, by occurrences
+
+    const CNF &cnf;
+    SolverConfig config;
+    size_t workers;
+    size_t depth;
+    std::vector<std::vector<int>> cubes;
+    size_t refuted;
+    std::vector<bool> values;
+
+    std::vector<size_t> occurrences; // of every variable in the formula
+
+    void split(Solver &splitter, std::vector<int> cube, size_t level); // the failed literals extend the copy
+};
+
+#endif //TASK3_CUBE_AND_CONQUER_HPP
@@ -0,0 +1,169 @@
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "dimacs.hpp"
+
+
+MappedFile::MappedFile(const std::string &path): data(nullptr), size(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat st{};
+    if (fstat(fd, &st) == 0 and S_ISREG(st.st_mode) and st.st_size > 0) {
+        void *mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char *>(mapped);
+            size = st.st_size;
+        }
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr)
+        munmap(const_cast<char *>(data), size);
+}
+
+
+static bool is_space(char c) {
+    return c == ' ' or c == '\t' or c == '\r' or c == '\v' or c == '\f';
+}
+
+static const char* skip_line(const char *p, const char *end) {
+    while (p < end and *p != '\n')
+        p++;
+    return p;
+}
+
+static const char* skip_spaces(const char *p, const char *end) {
+    while (p < end and is_space(*p))
+        p++;
+    return p;
+}
+
+static const char* read_number(const char *p, const char *end, long long &number) {
+    bool negative = p < end and *p == '-';
+    if (negative)
+        p++;
+    if (p == end or *p < '0' or *p > '9')
+        throw std::invalid_argument("Invalid DIMACS: number expected");
+
+    number = 0;
+    while (p < end and *p >= '0' and *p <= '9') {
+        number = number * 10 + (*p - '0');
+        if (number > INT32_MAX)
+            throw std::invalid_argument("Invalid DIMACS: number is too large");
+        p++;
+    }
+    if (negative)
+        number = -number;
+    return p;
+}
+
+static const char* read_header(const char *p, const char *end, DimacsData &data) {
+    // p cnf <variables> <clauses>
+    p = skip_spaces(p + 1, end);
+    if (end - p < 3 or p[0] != 'c' or p[1] != 'n' or p[2] != 'f')
+        throw std::invalid_argument("Invalid DIMACS: 'p cnf' header expected");
+
+    long long var_num, clause_num;
+    p = read_number(skip_spaces(p + 3, end), end, var_num);
+    p = read_number(skip_spaces(p, end), end, clause_num);
+    if (var_num < 0 or clause_num < 0)
+        throw std::invalid_argument("Invalid DIMACS: negative size in the header");
+
+    data.var_num = var_num;
+    data.clause_num = clause_num;
+    return skip_line(p, end);
+}
+
+
+void DimacsParser::feed(const char *begin, const char *end) {
+    if (stopped or begin == end)
+        return;
+    const char *last_line = end;
+    while (last_line > begin and last_line[-1] != '\n')
+        last_line--;
+    if (last_line == begin) {
+        carry.append(begin, end);
+        return;
+    }
+
+    const char *p = begin;
+    if (!carry.empty()) {
+        // completes the carried line, the rest of the chunk is scanned in place
+        while (*p != '\n')
+            p++;
+        carry.append(begin, ++p);
+        scan(carry.data(), carry.data() + carry.size());
+        carry.clear();
+    }
+    scan(p, last_line);
+    carry.assign(last_line, end);
+}
+
+void DimacsParser::finish() {
+    scan(carry.data(), carry.data() + carry.size());
+    carry.clear();
+    if (clause_open) {
+        // the last clause may be terminated by the end of the file
+        data.literals.push_back(0);
+        data.clauses_read++;
+        clause_open = false;
+    }
+}
+
+void DimacsParser::scan(const char *begin, const char *end) {
+    const char *p = begin;
+    bool line_start = true;
+
+    while (p < end and !stopped) {
+        char c = *p;
+        if (c == '\n') {
+            line_start = true;
+            p++;
+            continue;
+        }
+        if (is_space(c)) {
+            p++;
+            continue;
+        }
+
+        if (line_start and c == 'c') {
+            p = skip_line(p, end);
+            continue;
+        }
+        if (line_start and c == '%') {
+            stopped = true;
+            break;
+        }
+        if (line_start and c == 'p') {
+            p = read_header(p, end, data);
+            continue;
+        }
+        line_start = false;
+
+        long long literal;
+        p = read_number(p, end, literal);
+        if (std::llabs(literal) > (long long) data.var_num)
+            throw std::invalid_argument("Invalid DIMACS: variable is out of range");
+
+        data.literals.push_back(int(literal));
+        clause_open = literal != 0;
+        if (literal == 0)
+            data.clauses_read++;
+    }
+}
+
+
+void parse_dimacs(const char *begin, const char *end, DimacsData &data) {
+    DimacsParser parser(data);
+    parser.feed(begin, end);
+    parser.finish();
+}
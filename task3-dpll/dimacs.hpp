@@ -0,0 +1,60 @@
+#ifndef TASK3_DIMACS_HPP
+#define TASK3_DIMACS_HPP
+
+#include <string>
+#include <vector>
+
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+
+public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile& operator =(const MappedFile &) = delete;
+
+    [[nodiscard]] bool is_mapped() const { return data != nullptr; }
+    [[nodiscard]] const char* begin() const { return data; }
+    [[nodiscard]] const char* end() const { return data + size; }
+    [[nodiscard]] size_t bytes() const { return size; }
+
+private:
+    const char *data;
+    size_t size;
+};
+
+
+// DIMACS formula with the literals of all clauses stored one after another,
+// every clause terminated by 0
+struct DimacsData {
+    size_t var_num = 0;
+    size_t clause_num = 0;   // number of clauses declared in the header
+    size_t clauses_read = 0; // number of clauses found in the text
+    std::vector<int> literals;
+};
+
+// Scans DIMACS text given in chunks of any size into data, a line may be split between
+// two chunks. Clauses may span several lines, a line starting with '%' ends the formula
+// as in the SATLIB benchmarks.
+class DimacsParser {
+
+public:
+    explicit DimacsParser(DimacsData &data): data(data) {}
+
+    void feed(const char *begin, const char *end);
+    void finish(); // the end of the text, closes the last clause if it has no 0
+
+private:
+    DimacsData &data;
+    std::string carry;        // the unfinished last line of the previous chunks
+    bool clause_open = false;
+    bool stopped = false;     // after a '%' line
+
+    void scan(const char *begin, const char *end); // whole lines only
+};
+
+// Scans the whole DIMACS text in [begin, end) into data
+void parse_dimacs(const char *begin, const char *end, DimacsData &data);
+
+#endif //TASK3_DIMACS_HPP
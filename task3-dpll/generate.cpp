@@ -0,0 +1,70 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "generator.hpp"
+
+
+void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [-o FILE] ksat VARS [K=3] [RATIO=4.26] [SEED=0]" << std::endl;
+    std::cerr << "       " << program << " [-o FILE] pigeon HOLES" << std::endl;
+    std::cerr << "       " << program << " [-o FILE] coloring VERTICES EDGES COLORS [SEED=0]" << std::endl;
+    std::cerr << "       " << program << " [-o FILE] parity VARS sat|unsat [SEED=0]" << std::endl;
+    std::cerr << "           write the formula in DIMACS format to FILE or to the standard output" << std::endl;
+}
+
+CNF generate(const std::vector<std::string> &args) {
+    const auto &family = args.at(0);
+    auto arg = [&args](size_t i, uint64_t default_value) {
+        return i < args.size() ? std::stoull(args[i]) : default_value;
+    };
+    if (family == "ksat" and args.size() >= 2 and args.size() <= 5)
+        return random_ksat(arg(1, 0), arg(2, 3), args.size() > 3 ? std::stod(args[3]) : 4.26, arg(4, 0));
+    if (family == "pigeon" and args.size() == 2)
+        return pigeon_hole(arg(1, 0));
+    if (family == "coloring" and args.size() >= 4 and args.size() <= 5)
+        return graph_coloring(arg(1, 0), arg(2, 0), arg(3, 0), arg(4, 0));
+    if (family == "parity" and args.size() >= 3 and args.size() <= 4 and (args[2] == "sat" or args[2] == "unsat"))
+        return parity(arg(1, 0), args[2] == "sat", arg(3, 0));
+    throw std::invalid_argument("Unknown family or wrong number of parameters");
+}
+
+int main(int argc, char **argv) {
+    std::string output_path;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 and i + 1 < argc)
+            output_path = argv[++i];
+        else
+            args.emplace_back(argv[i]);
+    }
+    if (args.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        CNF cnf = generate(args);
+        std::ofstream fout;
+        if (!output_path.empty()) {
+            fout.open(output_path);
+            if (!fout) {
+                std::cerr << "Can not open " << output_path << std::endl;
+                return 2;
+            }
+        }
+        std::ostream &out = output_path.empty() ? std::cout : fout;
+        out << "c generated by " << argv[0];
+        for (const auto &arg : args)
+            out << " " << arg;
+        out << "\n";
+        cnf.write_dimacs(out);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        usage(argv[0]);
+        return 2;
+    }
+    return 0;
+}
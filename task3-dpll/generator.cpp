@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+#include "generator.hpp"
+
+
+CNF random_ksat(size_t var_num, size_t k, double ratio, uint64_t seed) {
+    if (k == 0 or k > var_num)
+        throw std::invalid_argument("Clause size must be between 1 and the number of variables");
+
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<int> variable(1, int(var_num));
+    auto clause_num = size_t(std::llround(ratio * double(var_num)));
+    ClauseArena clauses;
+    clauses.reserve(clause_num, clause_num * k);
+
+    std::vector<int> clause;
+    for (size_t i = 0; i < clause_num; i++) {
+        clause.clear();
+        while (clause.size() < k) {
+            int var = variable(random);
+            if (std::find(clause.begin(), clause.end(), var) == clause.end())
+                clause.push_back(var);
+        }
+        for (int &literal : clause)
+            if (random() & 1)
+                literal = -literal;
+        clauses.alloc(clause.data(), clause.size());
+    }
+    return CNF(var_num, std::move(clauses));
+}
+
+
+CNF pigeon_hole(size_t holes) {
+    size_t pigeons = holes + 1;
+    auto var = [holes](size_t pigeon, size_t hole) { return int(pigeon * holes + hole + 1); };
+    ClauseArena clauses;
+
+    std::vector<int> clause;
+    for (size_t p = 0; p < pigeons; p++) {
+        clause.clear();
+        for (size_t h = 0; h < holes; h++)
+            clause.push_back(var(p, h));
+        clauses.alloc(clause.data(), clause.size());
+    }
+    for (size_t h = 0; h < holes; h++) {
+        for (size_t p = 0; p < pigeons; p++) {
+            for (size_t q = p + 1; q < pigeons; q++) {
+                int pair[] = {-var(p, h), -var(q, h)};
+                clauses.alloc(pair, 2);
+            }
+        }
+    }
+    return CNF(pigeons * holes, std::move(clauses));
+}
+
+
+CNF graph_coloring(size_t vertices, size_t edges, size_t colors, uint64_t seed) {
+    if (colors == 0)
+        throw std::invalid_argument("At least one color is needed");
+
+    std::vector<std::pair<size_t, size_t>> graph;
+    uint64_t pairs = uint64_t(vertices) * (vertices - (vertices > 0)) / 2;
+    if (edges >= pairs) {
+        for (size_t u = 0; u < vertices; u++)
+            for (size_t v = u + 1; v < vertices; v++)
+                graph.emplace_back(u, v);
+    } else {
+        std::mt19937_64 random(seed);
+        std::uniform_int_distribution<size_t> vertex(0, vertices - 1);
+        std::unordered_set<uint64_t> taken;
+        while (graph.size() < edges) {
+            size_t u = vertex(random), v = vertex(random);
+            if (u == v)
+                continue;
+            if (u > v)
+                std::swap(u, v);
+            if (taken.insert(uint64_t(u) * vertices + v).second)
+                graph.emplace_back(u, v);
+        }
+    }
+
+    auto var = [colors](size_t vertex, size_t color) { return int(vertex * colors + color + 1); };
+    ClauseArena clauses;
+    std::vector<int> clause;
+    for (size_t v = 0; v < vertices; v++) {
+        // exactly one color for every vertex
+        clause.clear();
+        for (size_t c = 0; c < colors; c++)
+            clause.push_back(var(v, c));
+        clauses.alloc(clause.data(), clause.size());
+        for (size_t c = 0; c < colors; c++) {
+            for (size_t d = c + 1; d < colors; d++) {
+                int pair[] = {-var(v, c), -var(v, d)};
+                clauses.alloc(pair, 2);
+            }
+        }
+    }
+    for (auto [u, v] : graph) {
+        for (size_t c = 0; c < colors; c++) {
+            int pair[] = {-var(u, c), -var(v, c)};
+            clauses.alloc(pair, 2);
+        }
+    }
+    return CNF(vertices * colors, std::move(clauses));
+}
+
+
+// encodes sum = x_1 ^ ... ^ x_n with sum_i = sum_{i-1} ^ x_i, the new sums are numbered from next_var
+static int xor_chain(const std::vector<int> &vars, int &next_var, ClauseArena &clauses) {
+    int sum = vars[0];
+    for (size_t i = 1; i < vars.size(); i++) {
+        int a = sum, b = vars[i], t = next_var++;
+        int encoding[4][3] = {{-t, a, b}, {-t, -a, -b}, {t, -a, b}, {t, a, -b}};
+        for (auto &clause : encoding)
+            clauses.alloc(clause, 3);
+        sum = t;
+    }
+    return sum;
+}
+
+CNF parity(size_t var_num, bool satisfiable, uint64_t seed) {
+    if (var_num == 0)
+        throw std::invalid_argument("Parity needs at least one variable");
+
+    std::vector<int> vars(var_num);
+    std::iota(vars.begin(), vars.end(), 1);
+    ClauseArena clauses;
+    int next_var = int(var_num) + 1;
+
+    int first = xor_chain(vars, next_var, clauses);
+    std::mt19937_64 random(seed);
+    std::shuffle(vars.begin(), vars.end(), random);
+    int second = xor_chain(vars, next_var, clauses);
+
+    int units[] = {-first, satisfiable ? -second : second};
+    clauses.alloc(units, 1);
+    clauses.alloc(units + 1, 1);
+    return CNF(size_t(next_var - 1), std::move(clauses));
+}
@@ -0,0 +1,29 @@
+#ifndef TASK3_GENERATOR_HPP
+#define TASK3_GENERATOR_HPP
+
+#include <cstdint>
+#include <vector>
+#include "cnf.hpp"
+
+
+// Families of formulas for scaling studies; the same parameters and seed give the same formula
+
+// round(ratio * var_num) clauses of k distinct variables with random signs,
+// around ratio 4.26 random 3-SAT changes from mostly satisfiable to mostly unsatisfiable
+[[nodiscard]] CNF random_ksat(size_t var_num, size_t k, double ratio, uint64_t seed);
+
+// holes + 1 pigeons in holes holes, every pigeon in some hole and at most one pigeon
+// in every hole; always unsatisfiable, the variable of pigeon p in hole h is p * holes + h + 1
+[[nodiscard]] CNF pigeon_hole(size_t holes);
+
+// proper coloring of a random graph with the given number of distinct edges
+// (all of them are taken if there are fewer pairs); the variable of vertex v
+// with color c is v * colors + c + 1
+[[nodiscard]] CNF graph_coloring(size_t vertices, size_t edges, size_t colors, uint64_t seed);
+
+// x1 ^ ... ^ xn = 0 and the same sum over a random permutation of the variables
+// equal to 0 (satisfiable) or 1 (unsatisfiable), both chains encoded with
+// the auxiliary variables of the partial sums
+[[nodiscard]] CNF parity(size_t var_num, bool satisfiable, uint64_t seed);
+
+#endif //TASK3_GENERATOR_HPP
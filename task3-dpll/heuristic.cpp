@@ -0,0 +1,118 @@
+#include <stdexcept>
+#include "heuristic.hpp"
+
+
+VarHeap::VarHeap(const std::vector<double> &activity): activity(activity) {
+    positions = std::vector<size_t>(activity.size(), NOT_IN_HEAP);
+    heap.reserve(activity.size());
+}
+
+void VarHeap::insert(size_t var) {
+    if (contains(var))
+        return;
+    positions[var] = heap.size();
+    heap.push_back(var);
+    sift_up(heap.size() - 1);
+}
+
+void VarHeap::increased(size_t var) {
+    if (contains(var))
+        sift_up(positions[var]);
+}
+
+size_t VarHeap::pop() {
+    size_t var = heap[0];
+    heap[0] = heap.back();
+    positions[heap[0]] = 0;
+    positions[var] = NOT_IN_HEAP;
+    heap.pop_back();
+    if (heap.size() > 1)
+        sift_down(0);
+    return var;
+}
+
+void VarHeap::sift_up(size_t pos) {
+    size_t var = heap[pos];
+    while (pos > 0 and activity[heap[(pos - 1) / 2]] < activity[var]) {
+        heap[pos] = heap[(pos - 1) / 2];
+        positions[heap[pos]] = pos;
+        pos = (pos - 1) / 2;
+    }
+    heap[pos] = var;
+    positions[var] = pos;
+}
+
+void VarHeap::sift_down(size_t pos) {
+    size_t var = heap[pos];
+    while (2 * pos + 1 < heap.size()) {
+        size_t child = 2 * pos + 1;
+        if (child + 1 < heap.size() and activity[heap[child + 1]] > activity[heap[child]])
+            child++;
+        if (activity[heap[child]] <= activity[var])
+            break;
+        heap[pos] = heap[child];
+        positions[heap[pos]] = pos;
+        pos = child;
+    }
+    heap[pos] = var;
+    positions[var] = pos;
+}
+
+
+std::unique_ptr<Heuristic> Heuristic::create(Kind kind, size_t var_num) {
+    switch (kind) {
+        case FIRST_UNASSIGNED:
+            return std::make_unique<FirstUnassigned>(var_num);
+        case VSIDS:
+            return std::make_unique<Vsids>(var_num);
+    }
+    throw std::invalid_argument("Unknown heuristic");
+}
+
+
+size_t FirstUnassigned::pick(const std::vector<CNF::BoolTernary> &var_values) {
+    while (next < var_num and var_values[next] != CNF::BoolTernary::UNKNOWN)
+        next++;
+    return next;
+}
+
+
+Vsids::Vsids(size_t var_num, double decay_factor):
+        var_num(var_num), decay_factor(decay_factor), increment(1.0),
+        activity(var_num, 0.0), heap(activity) {
+    for (size_t var = 0; var < var_num; var++)
+        heap.insert(var);
+}
+
+size_t Vsids::pick(const std::vector<CNF::BoolTernary> &var_values) {
+    // assigned variables are removed lazily, they come back on unassignment
+    while (!heap.empty()) {
+        size_t var = heap.pop();
+        if (var_values[var] == CNF::BoolTernary::UNKNOWN)
+            return var;
+    }
+    return var_num;
+}
+
+void Vsids::unassigned(size_t var) {
+    heap.insert(var);
+}
+
+void Vsids::resize(size_t new_var_num) {
+    activity.resize(new_var_num, 0.0);
+    heap.resize(new_var_num);
+    for (size_t var = var_num; var < new_var_num; var++)
+        heap.insert(var);
+    var_num = new_var_num;
+}
+
+void Vsids::bump(size_t var) {
+    activity[var] += increment;
+    if (activity[var] > 1e100) {
+        // rescale everything to stay in the range of double, the order is kept
+        for (auto &value : activity)
+            value *= 1e-100;
+        increment *= 1e-100;
+    }
+    heap.increased(var);
+}
@@ -0,0 +1,92 @@
+#ifndef TASK3_HEURISTIC_HPP
+#define TASK3_HEURISTIC_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "cnf.hpp"
+
+
+// Binary max-heap of variables ordered by activity, with the position of every
+// variable stored so that its key can be increased in O(log n)
+class VarHeap {
+
+public:
+    explicit VarHeap(const std::vector<double> &activity);
+    void resize(size_t var_num) { positions.resize(var_num, NOT_IN_HEAP); }
+
+    [[nodiscard]] bool empty() const { return heap.empty(); }
+    [[nodiscard]] bool contains(size_t var) const { return positions[var] != NOT_IN_HEAP; }
+    void insert(size_t var);
+    void increased(size_t var); // restores the heap order after the activity of var grew
+    size_t pop();
+
+private:
+    static constexpr size_t NOT_IN_HEAP = SIZE_MAX;
+
+    const std::vector<double> &activity;
+    std::vector<size_t> heap;
+    std::vector<size_t> positions;
+
+    void sift_up(size_t pos);
+    void sift_down(size_t pos);
+};
+
+
+// Choice of the next decision variable
+class Heuristic {
+
+public:
+    enum Kind {
+        FIRST_UNASSIGNED, // the unassigned variable with the least number
+        VSIDS,            // the most active variable, activities bumped exponentially (EVSIDS)
+    };
+
+    static std::unique_ptr<Heuristic> create(Kind kind, size_t var_num);
+    virtual ~Heuristic() = default;
+
+    // returns the variable to branch on or var_num if all variables are assigned
+    [[nodiscard]] virtual size_t pick(const std::vector<CNF::BoolTernary> &var_values) = 0;
+    virtual void unassigned(size_t var) = 0; // the variable may be picked again
+    virtual void resize(size_t var_num) = 0; // new variables were added
+    virtual void bump(size_t /*var*/) {}     // the variable took part in a conflict
+    virtual void decay() {}                  // called once after every conflict
+};
+
+
+class FirstUnassigned final : public Heuristic {
+
+public:
+    explicit FirstUnassigned(size_t var_num): var_num(var_num), next(0) {}
+
+    [[nodiscard]] size_t pick(const std::vector<CNF::BoolTernary> &var_values) override;
+    void unassigned(size_t var) override { next = std::min(next, var); }
+    void resize(size_t new_var_num) override { var_num = new_var_num; }
+
+private:
+    size_t var_num;
+    size_t next; // all variables before next are assigned
+};
+
+
+class Vsids final : public Heuristic {
+
+public:
+    explicit Vsids(size_t var_num, double decay_factor = 0.95);
+
+    [[nodiscard]] size_t pick(const std::vector<CNF::BoolTernary> &var_values) override;
+    void unassigned(size_t var) override;
+    void resize(size_t new_var_num) override;
+    void bump(size_t var) override;
+    void decay() override { increment /= decay_factor; }
+
+private:
+    size_t var_num;
+    double decay_factor;
+    double increment;
+    std::vector<double> activity;
+    VarHeap heap;
+};
+
+#endif //TASK3_HEURISTIC_HPP
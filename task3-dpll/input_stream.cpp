@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "input_stream.hpp"
+
+// set by CMake when the libraries are found
+#ifndef TASK3_ZLIB
+#define TASK3_ZLIB 0
+#endif
+#ifndef TASK3_LZMA
+#define TASK3_LZMA 0
+#endif
+
+#if TASK3_ZLIB
+#include <zlib.h>
+#endif
+#if TASK3_LZMA
+#include <lzma.h>
+#endif
+
+
+InputStream::InputStream(FILE *file, std::string path, std::vector<char> prefix):
+        file(file), path(std::move(path)), prefix(std::move(prefix)), prefix_pos(0) {}
+
+InputStream::~InputStream() {
+    fclose(file);
+}
+
+size_t InputStream::read_raw(char *buffer, size_t size) {
+    size_t copied = std::min(size, prefix.size() - prefix_pos);
+    memcpy(buffer, prefix.data() + prefix_pos, copied);
+    prefix_pos += copied;
+    if (copied == size)
+        return copied;
+    size_t bytes = fread(buffer + copied, 1, size - copied, file);
+    if (bytes == 0 and ferror(file))
+        throw std::runtime_error("Can not read " + path);
+    return copied + bytes;
+}
+
+
+class PlainInput final : public InputStream {
+
+public:
+    PlainInput(FILE *file, std::string path, std::vector<char> prefix):
+            InputStream(file, std::move(path), std::move(prefix)) {}
+
+    size_t read(char *buffer, size_t size) override { return read_raw(buffer, size); }
+};
+
+
+#if TASK3_ZLIB
+class GzipInput final : public InputStream {
+
+public:
+    GzipInput(FILE *file, std::string path, std::vector<char> prefix):
+            InputStream(file, std::move(path), std::move(prefix)), input(CHUNK_SIZE), finished(false) {
+        memset(&stream, 0, sizeof(stream));
+        // 16 + MAX_WBITS: gzip wrapper
+        if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+            throw std::runtime_error("Can not start gzip decompression");
+    }
+    ~GzipInput() override { inflateEnd(&stream); }
+
+    size_t read(char *buffer, size_t size) override {
+        stream.next_out = reinterpret_cast<Bytef *>(buffer);
+        stream.avail_out = uInt(size);
+        while (stream.avail_out == size and !finished) {
+            if (stream.avail_in == 0) {
+                stream.avail_in = uInt(read_raw(input.data(), input.size()));
+                stream.next_in = reinterpret_cast<Bytef *>(input.data());
+                if (stream.avail_in == 0)
+                    throw std::runtime_error("Unexpected end of the gzip data in " + path);
+            }
+            int status = inflate(&stream, Z_NO_FLUSH);
+            if (status == Z_STREAM_END) {
+                // concatenated members, as written by gzip for appended files
+                if (stream.avail_in > 0 or !at_end())
+                    inflateReset(&stream);
+                else
+                    finished = true;
+            } else if (status != Z_OK) {
+                throw std::runtime_error("Invalid gzip data in " + path);
+            }
+        }
+        return size - stream.avail_out;
+    }
+
+private:
+    z_stream stream;
+    std::vector<char> input;
+    bool finished;
+
+    bool at_end() {
+        stream.avail_in = uInt(read_raw(input.data(), input.size()));
+        stream.next_in = reinterpret_cast<Bytef *>(input.data());
+        return stream.avail_in == 0;
+    }
+};
+#endif
+
+
+#if TASK3_LZMA
+class XzInput final : public InputStream {
+
+public:
+    XzInput(FILE *file, std::string path, std::vector<char> prefix):
+            InputStream(file, std::move(path), std::move(prefix)), stream(LZMA_STREAM_INIT),
+            input(CHUNK_SIZE), finished(false) {
+        if (lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+            throw std::runtime_error("Can not start xz decompression");
+    }
+    ~XzInput() override { lzma_end(&stream); }
+
+    size_t read(char *buffer, size_t size) override {
+        stream.next_out = reinterpret_cast<uint8_t *>(buffer);
+        stream.avail_out = size;
+        while (stream.avail_out == size and !finished) {
+            lzma_action action = LZMA_RUN;
+            if (stream.avail_in == 0) {
+                stream.avail_in = read_raw(input.data(), input.size());
+                stream.next_in = reinterpret_cast<uint8_t *>(input.data());
+                if (stream.avail_in == 0)
+                    action = LZMA_FINISH; // LZMA_CONCATENATED waits for it to end the last stream
+            }
+            lzma_ret status = lzma_code(&stream, action);
+            if (status == LZMA_STREAM_END)
+                finished = true;
+            else if (status != LZMA_OK)
+                throw std::runtime_error("Invalid xz data in " + path);
+        }
+        return size - stream.avail_out;
+    }
+
+private:
+    lzma_stream stream;
+    std::vector<char> input;
+    bool finished;
+};
+#endif
+
+
+InputStream::Format InputStream::detect(const char *begin, const char *end) {
+    static const unsigned char GZIP_MAGIC[] = {0x1f, 0x8b};
+    static const unsigned char XZ_MAGIC[] = {0xfd, '7', 'z', 'X', 'Z', 0x00};
+    auto starts_with = [begin, end](const unsigned char *magic, size_t size) {
+        return size_t(end - begin) >= size and memcmp(begin, magic, size) == 0;
+    };
+    if (starts_with(GZIP_MAGIC, sizeof(GZIP_MAGIC)))
+        return GZIP;
+    if (starts_with(XZ_MAGIC, sizeof(XZ_MAGIC)))
+        return XZ;
+    return PLAIN;
+}
+
+bool InputStream::supported(Format format) {
+    switch (format) {
+        case PLAIN:
+            return true;
+        case GZIP:
+            return TASK3_ZLIB;
+        case XZ:
+            return TASK3_LZMA;
+    }
+    return false;
+}
+
+std::unique_ptr<InputStream> InputStream::open(const std::string &path) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        throw std::invalid_argument("Can not open " + path);
+
+    std::vector<char> prefix(6);
+    prefix.resize(fread(prefix.data(), 1, prefix.size(), file));
+    Format format = detect(prefix.data(), prefix.data() + prefix.size());
+    if (!supported(format)) {
+        fclose(file);
+        throw std::invalid_argument(path + " is compressed in a format this build can not read");
+    }
+
+    switch (format) {
+#if TASK3_ZLIB
+        case GZIP:
+            return std::make_unique<GzipInput>(file, path, std::move(prefix));
+#endif
+#if TASK3_LZMA
+        case XZ:
+            return std::make_unique<XzInput>(file, path, std::move(prefix));
+#endif
+        default:
+            return std::make_unique<PlainInput>(file, path, std::move(prefix));
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef TASK3_INPUT_STREAM_HPP
+#define TASK3_INPUT_STREAM_HPP
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+// Sequential reader of a file that may be compressed: gzip and xz are recognized by their
+// first bytes and decompressed on the fly, anything else (pipes included) is read as it is
+class InputStream {
+
+public:
+    enum Format {
+        PLAIN,
+        GZIP, // needs zlib at build time
+        XZ,   // needs liblzma at build time
+    };
+
+    static std::unique_ptr<InputStream> open(const std::string &path); // throws if it can not be read
+    [[nodiscard]] static Format detect(const char *begin, const char *end); // by the magic bytes
+    [[nodiscard]] static bool supported(Format format);
+
+    virtual ~InputStream();
+    InputStream(const InputStream &) = delete;
+    InputStream& operator =(const InputStream &) = delete;
+
+    // fills buffer with up to size decompressed bytes, returns 0 only at the end of the data
+    virtual size_t read(char *buffer, size_t size) = 0;
+
+protected:
+    static constexpr size_t CHUNK_SIZE = 1 << 20;
+
+    InputStream(FILE *file, std::string path, std::vector<char> prefix);
+    size_t read_raw(char *buffer, size_t size); // the bytes of the file, the prefix first
+
+    FILE *file;
+    std::string path;
+
+private:
+    std::vector<char> prefix; // read to detect the format
+    size_t prefix_pos;
+};
+
+#endif //TASK3_INPUT_STREAM_HPP
@@ -0,0 +1,231 @@
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "local_search.hpp"
+
+
+LocalSearch::LocalSearch(const CNF &cnf, const LocalSearchConfig &config):
+        config(config), var_num(cnf.num_vars()), empty_clause_found(false),
+        occurrences(2 * cnf.num_vars()), random(config.seed), flip_count(0) {
+    // the clauses are copied with every literal once, the counters and the picks assume that;
+    // tautologies are always true and left out
+    std::vector<uint32_t> stamps(2 * var_num, 0);
+    uint32_t stamp = 0;
+    std::vector<int> literals;
+    const ClauseArena &formula = cnf.get_clauses();
+    arena.reserve(cnf.num_clauses(), formula.used_bytes() / sizeof(int));
+    for (auto it = formula.begin(); it != formula.end(); ++it) {
+        stamp++;
+        literals.clear();
+        bool tautology = false;
+        for (int literal : *it) {
+            tautology = tautology or stamps[lit_index(-literal)] == stamp;
+            if (stamps[lit_index(literal)] != stamp) {
+                stamps[lit_index(literal)] = stamp;
+                literals.push_back(literal);
+            }
+        }
+        if (literals.empty())
+            empty_clause_found = true;
+        if (tautology)
+            continue;
+        for (int literal : literals)
+            occurrences[lit_index(literal)].push_back(uint32_t(clauses.size()));
+        clauses.push_back(arena.alloc(literals.data(), literals.size()));
+    }
+
+    // probSAT with the polynomial break function, eps = 1
+    for (uint32_t breaks = 0; breaks < 64; breaks++)
+        break_weight.push_back(std::pow(1.0 + breaks, -config.cb));
+}
+
+
+void LocalSearch::initialize() {
+    values.resize(var_num);
+    for (size_t var = 0; var < var_num; var++)
+        values[var] = random() & 1;
+
+    true_count.assign(clauses.size(), 0);
+    true_xor.assign(clauses.size(), 0);
+    break_count.assign(var_num, 0);
+    make_count.assign(var_num, 0);
+    false_clauses.clear();
+    false_position.assign(clauses.size(), NOT_FALSE);
+
+    for (size_t var = 0; var < var_num; var++) {
+        int literal = values[var] ? int(var + 1) : -int(var + 1);
+        for (uint32_t clause : occurrences[lit_index(literal)]) {
+            true_count[clause]++;
+            true_xor[clause] ^= uint32_t(var);
+        }
+    }
+    for (uint32_t clause = 0; clause < clauses.size(); clause++) {
+        if (true_count[clause] == 0)
+            make_false(clause);
+        else if (true_count[clause] == 1)
+            break_count[true_xor[clause]]++;
+    }
+}
+
+void LocalSearch::make_false(uint32_t clause) {
+    false_position[clause] = false_clauses.size();
+    false_clauses.push_back(clause);
+    for (int literal : arena[clauses[clause]])
+        make_count[abs(literal) - 1]++;
+}
+
+void LocalSearch::make_true(uint32_t clause) {
+    uint32_t last = false_clauses.back();
+    false_clauses[false_position[clause]] = last;
+    false_position[last] = false_position[clause];
+    false_clauses.pop_back();
+    false_position[clause] = NOT_FALSE;
+    for (int literal : arena[clauses[clause]])
+        make_count[abs(literal) - 1]--;
+}
+
+void LocalSearch::flip(uint32_t var) {
+    values[var] = !values[var];
+    flip_count++;
+    int true_literal = values[var] ? int(var + 1) : -int(var + 1);
+
+    for (uint32_t clause : occurrences[lit_index(true_literal)]) {
+        if (true_count[clause] == 0) {
+            make_true(clause);
+            break_count[var]++;
+        } else if (true_count[clause] == 1) {
+            break_count[true_xor[clause]]--; // no longer the only true literal
+        }
+        true_count[clause]++;
+        true_xor[clause] ^= var;
+    }
+    for (uint32_t clause : occurrences[lit_index(-true_literal)]) {
+        true_count[clause]--;
+        true_xor[clause] ^= var;
+        if (true_count[clause] == 0) {
+            make_false(clause);
+            break_count[var]--;
+        } else if (true_count[clause] == 1) {
+            break_count[true_xor[clause]]++;
+        }
+    }
+}
+
+
+uint32_t LocalSearch::pick_walksat(uint32_t clause) {
+    // the least breaking variables, ties broken by make and then at random
+    candidates.clear();
+    uint32_t best_break = UINT32_MAX, best_make = 0;
+    for (int literal : arena[clauses[clause]]) {
+        uint32_t var = abs(literal) - 1;
+        uint32_t breaks = break_count[var], makes = make_count[var];
+        if (breaks < best_break or (breaks == best_break and makes > best_make)) {
+            candidates.clear();
+            best_break = breaks;
+            best_make = makes;
+        }
+        if (breaks == best_break and makes == best_make)
+            candidates.push_back(var);
+    }
+    auto clause_view = arena[clauses[clause]];
+    if (best_break > 0 and std::uniform_real_distribution<>(0, 1)(random) < config.noise)
+        return abs(clause_view[random() % clause_view.size()]) - 1;
+    return candidates[random() % candidates.size()];
+}
+
+uint32_t LocalSearch::pick_probsat(uint32_t clause) {
+    candidates.clear();
+    weights.clear();
+    double total = 0;
+    for (int literal : arena[clauses[clause]]) {
+        uint32_t var = abs(literal) - 1;
+        uint32_t breaks = break_count[var];
+        double weight = breaks < break_weight.size() ? break_weight[breaks] : std::pow(1.0 + breaks, -config.cb);
+        candidates.push_back(var);
+        weights.push_back(weight);
+        total += weight;
+    }
+    double point = std::uniform_real_distribution<>(0, total)(random);
+    for (size_t i = 0; i + 1 < candidates.size(); i++) {
+        point -= weights[i];
+        if (point < 0)
+            return candidates[i];
+    }
+    return candidates.back();
+}
+
+
+bool LocalSearch::solve() {
+    std::atomic<bool> never(false);
+    return solve(never) == CNF::BoolTernary::TRUE;
+}
+
+CNF::BoolTernary LocalSearch::solve(const std::atomic<bool> &stop) {
+    if (empty_clause_found)
+        return CNF::BoolTernary::UNKNOWN;
+    initialize();
+    flip_count = 0;
+    while (!false_clauses.empty()) {
+        if ((flip_count & 1023) == 0 and stop.load(std::memory_order_relaxed))
+            return CNF::BoolTernary::UNKNOWN;
+        if (config.max_flips != 0 and flip_count >= config.max_flips)
+            return CNF::BoolTernary::UNKNOWN;
+
+        uint32_t clause = false_clauses[random() % false_clauses.size()];
+        flip(config.kind == LocalSearchConfig::WALKSAT ? pick_walksat(clause) : pick_probsat(clause));
+    }
+    return CNF::BoolTernary::TRUE;
+}
+
+
+bool solve_hybrid(const CNF &cnf, const SolverConfig &config, std::vector<bool> *model) {
+    std::atomic<bool> stop(false);
+    std::mutex mutex;
+    CNF::BoolTernary result = CNF::BoolTernary::UNKNOWN;
+    std::exception_ptr error;
+
+    // the local search gives up only when the solver has answered
+    std::thread local_search([&]() {
+        try {
+            LocalSearchConfig local_config;
+            local_config.seed = config.seed;
+            LocalSearch search(cnf, local_config);
+            CNF::BoolTernary answer = search.solve(stop);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (answer == CNF::BoolTernary::TRUE and result == CNF::BoolTernary::UNKNOWN) {
+                result = answer;
+                if (model != nullptr)
+                    *model = search.model();
+                stop = true;
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            error = std::current_exception();
+        }
+    });
+
+    {
+        // however the solver returns, even by an exception, the local search is stopped and joined
+        struct StopAndJoin {
+            std::atomic<bool> &stop;
+            std::thread &thread;
+            ~StopAndJoin() {
+                stop = true;
+                thread.join();
+            }
+        } guard{stop, local_search};
+
+        Solver solver(cnf, config);
+        CNF::BoolTernary answer = solver.solve({}, stop);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (answer != CNF::BoolTernary::UNKNOWN and result == CNF::BoolTernary::UNKNOWN) {
+            result = answer;
+            if (answer == CNF::BoolTernary::TRUE and model != nullptr)
+                *model = solver.model();
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
+    return result == CNF::BoolTernary::TRUE;
+}
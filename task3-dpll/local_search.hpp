@@ -0,0 +1,81 @@
+#ifndef TASK3_LOCAL_SEARCH_HPP
+#define TASK3_LOCAL_SEARCH_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "cnf.hpp"
+#include "solver.hpp"
+
+
+struct LocalSearchConfig {
+    enum Kind {
+        WALKSAT, // a variable of a random false clause that breaks nothing, else a random one or the least breaking
+        PROBSAT, // a variable of a random false clause with probability (eps + break)^-cb
+    };
+
+    Kind kind = PROBSAT;
+    unsigned seed = 0;       // of the initial assignment and of every choice
+    double noise = 0.567;    // WALKSAT: probability of a random variable when all of them break something
+    double cb = 2.06;        // PROBSAT: the value tuned for random 3-SAT
+    uint64_t max_flips = 0;  // gives up after this number of flips, 0 - never
+};
+
+
+// Stochastic local search over complete assignments of a CNF formula: flips variables
+// of false clauses until none is left. The number of clauses each flip would make
+// false (break) and true (make) is updated incrementally, as well as the list of false clauses.
+// It finds models of satisfiable formulas, but can not prove unsatisfiability.
+class LocalSearch {
+
+public:
+    explicit LocalSearch(const CNF &cnf, const LocalSearchConfig &config = LocalSearchConfig());
+
+    [[nodiscard]] bool solve(); // true if a model was found within max_flips
+    // the same, but gives up with UNKNOWN as soon as stop is raised by another thread; never FALSE
+    [[nodiscard]] CNF::BoolTernary solve(const std::atomic<bool> &stop);
+    // the model found by solve, model[var] is the value of the variable var + 1
+    [[nodiscard]] const std::vector<bool>& model() const { return values; }
+    [[nodiscard]] uint64_t flips() const { return flip_count; }
+
+private:
+    static constexpr size_t NOT_FALSE = SIZE_MAX;
+
+    LocalSearchConfig config;
+    ClauseArena arena;                               // the clauses without repeated literals and tautologies
+    size_t var_num;
+    bool empty_clause_found;
+    std::vector<ClauseRef> clauses;                  // clauses of the formula by index
+    std::vector<std::vector<uint32_t>> occurrences;  // clause indices of each literal, indexed by lit_index
+
+    std::vector<bool> values;
+    std::vector<uint32_t> true_count;                // true literals of each clause
+    std::vector<uint32_t> true_xor;                  // xor of the variables of the true literals, the critical one for a count of 1
+    std::vector<uint32_t> break_count, make_count;   // by variable
+    std::vector<uint32_t> false_clauses;
+    std::vector<size_t> false_position;              // index in false_clauses or NOT_FALSE
+    std::vector<double> break_weight;                // PROBSAT: (eps + break)^-cb for small breaks
+    std::vector<uint32_t> candidates;
+    std::vector<double> weights;
+    std::mt19937_64 random;
+    uint64_t flip_count;
+
+    static size_t lit_index(int literal) { return 2 * (abs(literal) - 1) + (literal < 0); }
+    [[nodiscard]] bool is_true(int literal) const { return values[abs(literal) - 1] == (literal > 0); }
+
+    void initialize(); // random assignment and the counters for it
+    void make_false(uint32_t clause);
+    void make_true(uint32_t clause);
+    void flip(uint32_t var);
+    [[nodiscard]] uint32_t pick_walksat(uint32_t clause);
+    [[nodiscard]] uint32_t pick_probsat(uint32_t clause);
+};
+
+
+// Runs the local search alongside the systematic solver with the given configuration,
+// the first answer is taken and the other search is cancelled; used by CNF::is_sat
+// when SolverConfig::local_search is set
+[[nodiscard]] bool solve_hybrid(const CNF &cnf, const SolverConfig &config, std::vector<bool> *model = nullptr);
+
+#endif //TASK3_LOCAL_SEARCH_HPP
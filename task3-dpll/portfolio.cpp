@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "portfolio.hpp"
+
+
+Portfolio::Portfolio(const CNF &cnf, size_t workers, bool share_clauses):
+        cnf(cnf), share_clauses(share_clauses), winner_index(0) {
+    if (workers == 0)
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < workers; i++)
+        configs.push_back(diversified(i));
+}
+
+Portfolio::Portfolio(const CNF &cnf, std::vector<SolverConfig> configs, bool share_clauses):
+        cnf(cnf), configs(std::move(configs)), share_clauses(share_clauses), winner_index(0) {
+    if (this->configs.empty())
+        throw std::invalid_argument("Portfolio needs at least one solver");
+}
+
+
+SolverConfig Portfolio::diversified(size_t index) {
+    SolverConfig config;
+    switch (index) {
+        case 0:
+            break;
+        case 1:
+            config.heuristic = Heuristic::FIRST_UNASSIGNED;
+            break;
+        case 2:
+            config.phase_saving = false;
+            break;
+        case 3:
+            config.algorithm = CNF::DPLL;
+            break;
+        case 4:
+            config.restarts = RestartPolicy::LUBY;
+            break;
+        case 5:
+            config.restarts = RestartPolicy::GEOMETRIC;
+            break;
+        default:
+            config.seed = index;
+            config.random_var_freq = 0.01 * double(index % 5);
+            config.restarts = index % 2 == 0 ? RestartPolicy::LUBY : RestartPolicy::GLUCOSE;
+            break;
+    }
+    return config;
+}
+
+
+bool Portfolio::solve() {
+    std::atomic<bool> stop(false);
+    std::mutex mutex;
+    CNF::BoolTernary result = CNF::BoolTernary::UNKNOWN;
+    std::exception_ptr error;
+    auto exchange = share_clauses ? std::make_unique<ClauseExchange>() : nullptr;
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < configs.size(); i++) {
+        threads.emplace_back([&, i]() {
+            try {
+                Solver solver(cnf, configs[i]);
+                if (exchange)
+                    solver.share_clauses(exchange.get(), i);
+
+                CNF::BoolTernary answer = solver.solve({}, stop);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (answer != CNF::BoolTernary::UNKNOWN and result == CNF::BoolTernary::UNKNOWN) {
+                    result = answer;
+                    winner_index = i;
+                    stop = true;
+                }
+            } catch (...) {
+                // an exception leaving the thread would terminate the process, the caller gets it instead
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+                stop = true;
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+    return result == CNF::BoolTernary::TRUE;
+}
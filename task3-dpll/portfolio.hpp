@@ -0,0 +1,29 @@
+#ifndef TASK3_PORTFOLIO_HPP
+#define TASK3_PORTFOLIO_HPP
+
+#include <vector>
+#include "cnf.hpp"
+#include "solver.hpp"
+
+
+// Runs differently configured solvers on the same formula in parallel threads,
+// the first one to finish gives the answer and the others are cancelled
+class Portfolio {
+
+public:
+    explicit Portfolio(const CNF &cnf, size_t workers = 0, bool share_clauses = true); // 0 - one per core
+    Portfolio(const CNF &cnf, std::vector<SolverConfig> configs, bool share_clauses = true);
+
+    [[nodiscard]] bool solve();
+    [[nodiscard]] const SolverConfig& winner() const { return configs[winner_index]; }
+
+    static SolverConfig diversified(size_t index); // configuration of the index-th worker
+
+private:
+    const CNF &cnf;
+    std::vector<SolverConfig> configs;
+    bool share_clauses;
+    size_t winner_index;
+};
+
+#endif //TASK3_PORTFOLIO_HPP
@@ -0,0 +1,451 @@
+#include <algorithm>
+#include "preprocessor.hpp"
+
+static constexpr size_t SUBSUMPTION_BUDGET = 50000000; // literal visits
+static constexpr size_t MAX_OCCURRENCES = 10;          // both polarities more frequent - not eliminated
+static constexpr size_t MAX_RESOLVENT_SIZE = 20;
+static constexpr size_t MAX_ROUNDS = 3;
+
+
+Preprocessor::Preprocessor(const CNF &cnf, ProofWriter *proof):
+        var_num(cnf.num_vars()), unsat(false), budget(SUBSUMPTION_BUDGET), proof(proof) {
+    occurs.resize(2 * var_num);
+    values = std::vector<CNF::BoolTernary>(var_num, CNF::BoolTernary::UNKNOWN);
+    eliminated = std::vector<bool>(var_num, false);
+    frozen = std::vector<bool>(var_num, false);
+    marks = std::vector<bool>(2 * var_num, false);
+    touched = std::vector<bool>(var_num, true);
+
+    clauses.reserve(cnf.num_clauses());
+    for (auto clause : cnf.get_clauses())
+        add_clause(std::vector<int>(clause.begin(), clause.end()), false);
+}
+
+
+static CNF::BoolTernary get_value(int literal, const std::vector<CNF::BoolTernary> &values) {
+    CNF::BoolTernary value = values[abs(literal) - 1];
+    if (literal > 0 or value == CNF::BoolTernary::UNKNOWN)
+        return value;
+    return value == CNF::BoolTernary::TRUE ? CNF::BoolTernary::FALSE : CNF::BoolTernary::TRUE;
+}
+
+void Preprocessor::add_clause(std::vector<int> clause, bool derived) {
+    std::sort(clause.begin(), clause.end());
+    clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+    for (int literal : clause) {
+        if (std::binary_search(clause.begin(), clause.end(), -literal)) {
+            statistics.tautologies++;
+            return;
+        }
+        if (get_value(literal, values) == CNF::BoolTernary::TRUE)
+            return;
+    }
+    size_t size = clause.size();
+    clause.erase(std::remove_if(clause.begin(), clause.end(), [this](int literal) {
+        return get_value(literal, values) == CNF::BoolTernary::FALSE;
+    }), clause.end());
+    if (proof != nullptr and !clause.empty() and (derived or clause.size() < size))
+        proof->add(clause);
+
+    if (clause.empty()) {
+        unsat = true;
+        return;
+    }
+    if (clause.size() == 1) {
+        units.push_back(clause[0]);
+        return;
+    }
+
+    for (int literal : clause) {
+        occurs[lit_index(literal)].push_back(clauses.size());
+        touched[abs(literal) - 1] = true;
+    }
+    queue.push_back(clauses.size());
+    clauses.push_back(std::move(clause));
+    removed.push_back(false);
+}
+
+void Preprocessor::remove_clause(size_t index) {
+    // occurrence lists are cleaned lazily by live_occurs
+    removed[index] = true;
+    // units stay in the proof, they are the reasons of the fixed values
+    if (proof != nullptr and clauses[index].size() > 1)
+        proof->remove(clauses[index]);
+    for (int literal : clauses[index])
+        touched[abs(literal) - 1] = true;
+}
+
+void Preprocessor::strengthen(size_t index, int literal) {
+    auto &clause = clauses[index];
+    auto position = std::find(clause.begin(), clause.end(), literal);
+    if (proof != nullptr) {
+        std::vector<int> original(clause);
+        clause.erase(position);
+        proof->add(clause);
+        proof->remove(original);
+    } else {
+        clause.erase(position);
+    }
+    auto &occurrences = occurs[lit_index(literal)];
+    occurrences.erase(std::find(occurrences.begin(), occurrences.end(), index));
+    for (int other : clause)
+        touched[abs(other) - 1] = true;
+
+    if (clause.empty())
+        unsat = true;
+    else if (clause.size() == 1)
+        units.push_back(clause[0]);
+    queue.push_back(index);
+}
+
+const std::vector<size_t>& Preprocessor::live_occurs(int literal) {
+    auto &occurrences = occurs[lit_index(literal)];
+    occurrences.erase(std::remove_if(occurrences.begin(), occurrences.end(), [this](size_t index) {
+        return removed[index];
+    }), occurrences.end());
+    return occurrences;
+}
+
+
+void Preprocessor::fix(int literal) {
+    // the variable leaves the formula, the model gets the literal back on reconstruction
+    CNF::BoolTernary value = get_value(literal, values);
+    if (value == CNF::BoolTernary::FALSE)
+        unsat = true;
+    if (value != CNF::BoolTernary::UNKNOWN)
+        return;
+
+    values[abs(literal) - 1] = literal > 0 ? CNF::BoolTernary::TRUE : CNF::BoolTernary::FALSE;
+    eliminated[abs(literal) - 1] = true;
+    reconstruction.emplace_back(literal, std::vector<int>({literal}));
+
+    for (size_t index : live_occurs(literal))
+        remove_clause(index);
+    std::vector<size_t> negative = live_occurs(-literal); // strengthen changes the list
+    for (size_t index : negative)
+        strengthen(index, -literal);
+    occurs[lit_index(literal)].clear();
+    occurs[lit_index(-literal)].clear();
+}
+
+void Preprocessor::propagate_units() {
+    while (!units.empty() and !unsat) {
+        int literal = units.back();
+        units.pop_back();
+        if (get_value(literal, values) == CNF::BoolTernary::UNKNOWN)
+            statistics.units++;
+        fix(literal);
+    }
+}
+
+void Preprocessor::remove_duplicates() {
+    std::vector<size_t> order;
+    for (size_t i = 0; i < clauses.size(); i++)
+        if (!removed[i])
+            order.push_back(i);
+    std::sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+        return clauses[lhs] < clauses[rhs];
+    });
+
+    for (size_t i = 1; i < order.size(); i++) {
+        if (clauses[order[i]] == clauses[order[i - 1]]) {
+            remove_clause(order[i]);
+            statistics.duplicates++;
+        }
+    }
+}
+
+void Preprocessor::eliminate_pure_literals() {
+    for (size_t var = 0; var < var_num and !unsat; var++) {
+        if (eliminated[var] or frozen[var])
+            continue;
+        int literal = int(var + 1);
+        bool positive = !live_occurs(literal).empty();
+        bool negative = !live_occurs(-literal).empty();
+        if (positive == negative)
+            continue;
+
+        // unlike a fixed value the literal is not implied, so its clauses are kept
+        // for the reconstruction instead of a unit
+        statistics.pure_literals++;
+        literal = positive ? literal : -literal;
+        std::vector<size_t> occurrences = live_occurs(literal);
+        for (size_t index : occurrences) {
+            reconstruction.emplace_back(literal, clauses[index]);
+            remove_clause(index);
+        }
+        occurs[lit_index(literal)].clear();
+        eliminated[var] = true;
+    }
+}
+
+
+void Preprocessor::subsume(size_t index) {
+    // every clause that is subsumed or strengthened by the given one contains one of
+    // its literals, so it is enough to look through the shortest pair of occurrence lists
+    const auto &clause = clauses[index];
+    int best = clause[0];
+    for (int literal : clause)
+        if (occurs[lit_index(literal)].size() + occurs[lit_index(-literal)].size()
+                < occurs[lit_index(best)].size() + occurs[lit_index(-best)].size())
+            best = literal;
+
+    std::vector<size_t> candidates = live_occurs(best);
+    for (size_t other : live_occurs(-best))
+        candidates.push_back(other);
+
+    for (int literal : clause)
+        marks[lit_index(literal)] = true;
+
+    for (size_t other : candidates) {
+        if (other == index or removed[other] or clauses[other].size() < clause.size())
+            continue;
+        if (budget < clauses[other].size())
+            break;
+        budget -= clauses[other].size();
+
+        size_t matched = 0;
+        int flipped = 0;
+        bool several_flipped = false;
+        for (int literal : clauses[other]) {
+            if (marks[lit_index(literal)]) {
+                matched++;
+            } else if (marks[lit_index(-literal)]) {
+                several_flipped = flipped != 0;
+                flipped = literal;
+            }
+        }
+
+        if (several_flipped)
+            continue;
+        if (flipped == 0 and matched == clause.size()) {
+            remove_clause(other);
+            statistics.subsumed++;
+        } else if (flipped != 0 and matched + 1 == clause.size()) {
+            // self-subsuming resolution: (C or l) and (C or D or ~l) give (C or D)
+            strengthen(other, flipped);
+            statistics.strengthened++;
+        }
+    }
+
+    for (int literal : clause)
+        marks[lit_index(literal)] = false;
+}
+
+void Preprocessor::backward_subsumption() {
+    while (!queue.empty() and !unsat and budget > 0) {
+        std::vector<size_t> current;
+        current.swap(queue);
+        std::sort(current.begin(), current.end(), [this](size_t lhs, size_t rhs) {
+            return clauses[lhs].size() < clauses[rhs].size() or (clauses[lhs].size() == clauses[rhs].size() and lhs < rhs);
+        });
+        current.erase(std::unique(current.begin(), current.end()), current.end());
+
+        for (size_t index : current)
+            if (!removed[index] and clauses[index].size() > 1)
+                subsume(index);
+        propagate_units();
+    }
+    queue.clear();
+}
+
+bool Preprocessor::forward_subsumed(const std::vector<int> &clause) {
+    for (int literal : clause)
+        marks[lit_index(literal)] = true;
+
+    bool subsumed = false;
+    for (size_t i = 0; i < clause.size() and !subsumed; i++) {
+        for (size_t other : occurs[lit_index(clause[i])]) {
+            if (removed[other] or clauses[other].size() > clause.size())
+                continue;
+            subsumed = std::all_of(clauses[other].begin(), clauses[other].end(), [this](int literal) {
+                return marks[lit_index(literal)];
+            });
+            if (subsumed)
+                break;
+        }
+    }
+
+    for (int literal : clause)
+        marks[lit_index(literal)] = false;
+    return subsumed;
+}
+
+
+bool Preprocessor::resolve(const std::vector<int> &lhs, const std::vector<int> &rhs, int pivot,
+                           std::vector<int> &resolvent) const {
+    resolvent.clear();
+    size_t i = 0, j = 0;
+    while (i < lhs.size() or j < rhs.size()) {
+        // both clauses are sorted, so the resolvent is merged in order
+        int literal;
+        if (j == rhs.size() or (i < lhs.size() and lhs[i] < rhs[j])) {
+            literal = lhs[i++];
+        } else if (i == lhs.size() or rhs[j] < lhs[i]) {
+            literal = rhs[j++];
+        } else {
+            literal = lhs[i++];
+            j++;
+        }
+
+        if (abs(literal) == pivot)
+            continue;
+        if (std::binary_search(lhs.begin(), lhs.end(), -literal) or std::binary_search(rhs.begin(), rhs.end(), -literal))
+            return false;
+        resolvent.push_back(literal);
+    }
+    return true;
+}
+
+bool Preprocessor::eliminate_var(size_t var) {
+    int literal = int(var + 1);
+    const std::vector<size_t> &positive = live_occurs(literal);
+    const std::vector<size_t> &negative = live_occurs(-literal);
+    if (positive.empty() or negative.empty())
+        return false;
+    if (positive.size() > MAX_OCCURRENCES and negative.size() > MAX_OCCURRENCES)
+        return false;
+
+    // the variable goes away only if the resolvents are not more than the clauses they replace
+    std::vector<std::vector<int>> resolvents;
+    std::vector<int> resolvent;
+    for (size_t pos : positive) {
+        for (size_t neg : negative) {
+            if (budget < clauses[pos].size() + clauses[neg].size())
+                return false;
+            budget -= clauses[pos].size() + clauses[neg].size();
+
+            if (!resolve(clauses[pos], clauses[neg], literal, resolvent))
+                continue;
+            if (resolvent.size() > MAX_RESOLVENT_SIZE or resolvents.size() == positive.size() + negative.size())
+                return false;
+            resolvents.push_back(resolvent);
+        }
+    }
+
+    // the resolvents are derived before their antecedents are removed
+    for (auto &clause : resolvents)
+        if (!forward_subsumed(clause))
+            add_clause(std::move(clause), true);
+    for (size_t index : positive) {
+        reconstruction.emplace_back(literal, clauses[index]);
+        remove_clause(index);
+    }
+    for (size_t index : negative) {
+        reconstruction.emplace_back(-literal, clauses[index]);
+        remove_clause(index);
+    }
+    eliminated[var] = true;
+    statistics.eliminated_vars++;
+    propagate_units();
+    return true;
+}
+
+bool Preprocessor::eliminate_vars() {
+    std::vector<std::pair<size_t, size_t>> order; // (cost, variable)
+    for (size_t var = 0; var < var_num; var++) {
+        // a variable that failed to be eliminated is tried again only when its clauses change
+        if (!eliminated[var] and !frozen[var] and touched[var]) {
+            touched[var] = false;
+            size_t positive = occurs[lit_index(int(var + 1))].size();
+            size_t negative = occurs[lit_index(-int(var + 1))].size();
+            order.emplace_back(positive * negative, var);
+        }
+    }
+    std::sort(order.begin(), order.end());
+
+    bool changed = false;
+    for (auto &[cost, var] : order) {
+        if (unsat or budget == 0)
+            break;
+        if (!eliminated[var] and eliminate_var(var))
+            changed = true;
+    }
+    return changed;
+}
+
+
+bool Preprocessor::run() {
+    propagate_units();
+    if (unsat)
+        return false;
+    remove_duplicates();
+
+    for (size_t round = 0; round < MAX_ROUNDS and !unsat; round++) {
+        eliminate_pure_literals();
+        propagate_units();
+        backward_subsumption();
+        if (unsat or (!eliminate_vars() and queue.empty()))
+            break;
+    }
+    return !unsat;
+}
+
+void Preprocessor::freeze(size_t var) {
+    frozen[var] = true;
+}
+
+std::vector<std::pair<int, std::vector<int>>> Preprocessor::restore(const std::vector<size_t> &vars) {
+    std::vector<bool> restored(var_num, false);
+    std::vector<size_t> pending;
+    for (size_t var : vars) {
+        if (eliminated[var] and !restored[var]) {
+            restored[var] = true;
+            pending.push_back(var);
+        }
+    }
+
+    // a removed clause may contain variables eliminated after it, they come back as well
+    std::vector<std::pair<int, std::vector<int>>> result;
+    while (!pending.empty()) {
+        pending.clear();
+        size_t kept = 0;
+        for (auto &entry : reconstruction) {
+            if (!restored[abs(entry.first) - 1]) {
+                if (&entry != &reconstruction[kept])
+                    reconstruction[kept] = std::move(entry);
+                kept++;
+                continue;
+            }
+            for (int literal : entry.second) {
+                size_t var = abs(literal) - 1;
+                if (eliminated[var] and !restored[var]) {
+                    restored[var] = true;
+                    pending.push_back(var);
+                }
+            }
+            result.push_back(std::move(entry));
+        }
+        reconstruction.resize(kept);
+    }
+    for (size_t var = 0; var < var_num; var++) {
+        if (restored[var]) {
+            eliminated[var] = false;
+            values[var] = CNF::BoolTernary::UNKNOWN;
+        }
+    }
+    // the variables found in the removed clauses went after the ones that brought them back,
+    // so the clauses are returned in the reverse order of their removal
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+CNF Preprocessor::simplified() const {
+    ClauseArena arena;
+    for (size_t i = 0; i < clauses.size(); i++)
+        if (!removed[i])
+            arena.alloc(clauses[i].data(), clauses[i].size());
+    return CNF(var_num, std::move(arena));
+}
+
+void Preprocessor::extend_model(std::vector<bool> &model) const {
+    // undo the eliminations from the last one, flipping a variable whenever one of its clauses is false
+    for (auto it = reconstruction.rbegin(); it != reconstruction.rend(); it++) {
+        const auto &[witness, clause] = *it;
+        bool satisfied = std::any_of(clause.begin(), clause.end(), [&model](int literal) {
+            return model[abs(literal) - 1] == (literal > 0);
+        });
+        if (!satisfied)
+            model[abs(witness) - 1] = witness > 0;
+    }
+}
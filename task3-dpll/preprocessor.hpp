@@ -0,0 +1,89 @@
+#ifndef TASK3_PREPROCESSOR_HPP
+#define TASK3_PREPROCESSOR_HPP
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "cnf.hpp"
+#include "proof.hpp"
+
+
+struct PreprocessStats {
+    size_t tautologies = 0;
+    size_t duplicates = 0;
+    size_t units = 0;           // variables fixed by unit propagation
+    size_t pure_literals = 0;
+    size_t subsumed = 0;        // clauses removed because a subset of them is in the formula
+    size_t strengthened = 0;    // literals removed by self-subsuming resolution
+    size_t eliminated_vars = 0; // variables removed by bounded variable elimination
+};
+
+
+// Simplifies a formula before the search while keeping its satisfiability:
+// tautology and duplicate removal, unit propagation, pure literals, subsumption,
+// self-subsuming resolution and bounded variable elimination. The clauses removed
+// together with a variable are kept to extend a model of the result to the original formula,
+// or to put them back when the variable is used again.
+class Preprocessor {
+
+public:
+    // every clause that is derived or removed is written to the proof if it is given
+    explicit Preprocessor(const CNF &cnf, ProofWriter *proof = nullptr);
+
+    void freeze(size_t var); // the variable is neither eliminated nor removed as pure, call before run
+    [[nodiscard]] bool run(); // returns false if the formula is found unsatisfiable
+    [[nodiscard]] CNF simplified() const;
+
+    // gives values to the removed variables so that the original clauses are satisfied,
+    // model[var] is the value of the variable var + 1
+    void extend_model(std::vector<bool> &model) const;
+
+    [[nodiscard]] size_t num_vars() const { return eliminated.size(); }
+    [[nodiscard]] bool is_eliminated(size_t var) const { return eliminated[var]; }
+    // brings the eliminated variables back, together with the ones in their removed clauses;
+    // returns those clauses (with the literal of the removed variable) to be added to the formula again
+    [[nodiscard]] std::vector<std::pair<int, std::vector<int>>> restore(const std::vector<size_t> &vars);
+    [[nodiscard]] const PreprocessStats& stats() const { return statistics; }
+
+private:
+    size_t var_num;
+    bool unsat;
+    PreprocessStats statistics;
+
+    std::vector<std::vector<int>> clauses;   // sorted literals
+    std::vector<bool> removed;
+    std::vector<std::vector<size_t>> occurs; // clauses containing each literal, indexed by lit_index
+    std::vector<CNF::BoolTernary> values;    // values fixed at the top level
+    std::vector<bool> eliminated;            // variable does not occur in the formula any more
+    std::vector<bool> frozen;                // variable is kept for the clauses added later
+    std::vector<bool> touched;               // clauses of the variable changed since its last elimination attempt
+    std::vector<int> units;                  // fixed literals to propagate
+    std::vector<size_t> queue;               // clauses to try for subsumption
+    std::vector<bool> marks;                 // literals of the current clause, indexed by lit_index
+    size_t budget;                           // literal visits left for subsumption and elimination
+    ProofWriter *proof;
+
+    // clauses of the eliminated variables in the order of elimination with the literal to flip
+    std::vector<std::pair<int, std::vector<int>>> reconstruction;
+
+    static size_t lit_index(int literal) { return 2 * (abs(literal) - 1) + (literal < 0); }
+
+    void add_clause(std::vector<int> clause, bool derived); // derived clauses go to the proof
+    void remove_clause(size_t index);
+    void strengthen(size_t index, int literal); // removes literal from the clause
+    void fix(int literal);
+    [[nodiscard]] const std::vector<size_t>& live_occurs(int literal); // drops the removed clauses
+
+    void propagate_units();
+    void remove_duplicates();
+    void eliminate_pure_literals();
+    void subsume(size_t index);
+    void backward_subsumption();
+    [[nodiscard]] bool forward_subsumed(const std::vector<int> &clause);
+    [[nodiscard]] bool resolve(const std::vector<int> &lhs, const std::vector<int> &rhs, int pivot,
+                               std::vector<int> &resolvent) const; // false for tautologies
+    bool eliminate_var(size_t var);
+    bool eliminate_vars();
+};
+
+#endif //TASK3_PREPROCESSOR_HPP
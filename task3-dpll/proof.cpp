@@ -0,0 +1,95 @@
+#include <cstdlib>
+#include <stdexcept>
+#include "proof.hpp"
+
+
+ProofWriter::ProofWriter(std::ostream &out, size_t buffer_size):
+        out(out), buffer(buffer_size), pending(buffer_size) {
+    writer = std::thread(&ProofWriter::run, this);
+}
+
+ProofWriter::ProofWriter(const std::string &path, size_t buffer_size):
+        file(std::make_unique<std::ofstream>(path, std::ios::binary)), out(*file),
+        buffer(buffer_size), pending(buffer_size) {
+    if (!*file)
+        throw std::invalid_argument("Can not open " + path);
+    writer = std::thread(&ProofWriter::run, this);
+}
+
+ProofWriter::~ProofWriter() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    writer.join();
+}
+
+
+void ProofWriter::add(const int *begin, const int *end) {
+    write_step('a', begin, end);
+}
+
+void ProofWriter::remove(const int *begin, const int *end) {
+    write_step('d', begin, end);
+}
+
+void ProofWriter::write_step(char type, const int *begin, const int *end) {
+    // a literal takes at most 5 bytes
+    size_t max_size = 5 * (end - begin) + 2;
+    if (used + max_size > buffer.size()) {
+        hand_over();
+        if (max_size > buffer.size())
+            buffer.resize(max_size);
+    }
+
+    char *data = buffer.data() + used;
+    *data++ = type;
+    for (const int *it = begin; it != end; it++) {
+        uint32_t value = 2 * uint32_t(abs(*it)) + (*it < 0);
+        while (value > 127) {
+            *data++ = char((value & 127) | 128);
+            value >>= 7;
+        }
+        *data++ = char(value);
+    }
+    *data++ = 0;
+    used = data - buffer.data();
+    step_num++;
+}
+
+void ProofWriter::hand_over() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return !has_pending; });
+    buffer.swap(pending);
+    pending_size = used;
+    byte_num += used;
+    used = 0;
+    has_pending = true;
+    changed.notify_all();
+}
+
+void ProofWriter::flush() {
+    if (used > 0)
+        hand_over();
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return !has_pending; });
+    out.flush();
+}
+
+void ProofWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this]() { return has_pending or stopping; });
+        if (!has_pending)
+            return;
+
+        // the solver only touches the other buffer while this one is written
+        lock.unlock();
+        out.write(pending.data(), std::streamsize(pending_size));
+        lock.lock();
+        has_pending = false;
+        changed.notify_all();
+    }
+}
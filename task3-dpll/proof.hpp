@@ -0,0 +1,58 @@
+#ifndef TASK3_PROOF_HPP
+#define TASK3_PROOF_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Writes a DRAT proof in the binary format: 'a' or 'd', then every literal l
+// as the unsigned 2 * |l| + (l < 0) in 7-bit groups (the high bit marks continuation), then 0.
+// The solver only encodes the steps into a buffer, a full buffer is swapped with
+// the one of a background thread that writes it to the stream.
+class ProofWriter {
+
+public:
+    explicit ProofWriter(std::ostream &out, size_t buffer_size = 1 << 20);
+    explicit ProofWriter(const std::string &path, size_t buffer_size = 1 << 20);
+    ~ProofWriter(); // writes the rest of the proof
+    ProofWriter(const ProofWriter &) = delete;
+    ProofWriter& operator =(const ProofWriter &) = delete;
+
+    void add(const int *begin, const int *end);    // lemma, must follow from the clauses added before
+    void remove(const int *begin, const int *end); // clause deletion
+    void add(const std::vector<int> &clause) { add(clause.data(), clause.data() + clause.size()); }
+    void remove(const std::vector<int> &clause) { remove(clause.data(), clause.data() + clause.size()); }
+    void flush(); // blocks until everything written so far reaches the stream
+
+    [[nodiscard]] uint64_t steps() const { return step_num; }
+    [[nodiscard]] uint64_t bytes() const { return byte_num + used; }
+
+private:
+    std::unique_ptr<std::ofstream> file;
+    std::ostream &out;
+    std::vector<char> buffer;  // filled by the solver
+    size_t used = 0;
+    std::vector<char> pending; // written by the background thread
+    size_t pending_size = 0;
+    uint64_t step_num = 0;
+    uint64_t byte_num = 0;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool has_pending = false;
+    bool stopping = false;
+    std::thread writer;
+
+    void write_step(char type, const int *begin, const int *end);
+    void hand_over(); // gives the filled buffer to the background thread
+    void run();
+};
+
+#endif //TASK3_PROOF_HPP
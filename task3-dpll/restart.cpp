@@ -0,0 +1,67 @@
+#include <stdexcept>
+#include "restart.hpp"
+
+
+std::unique_ptr<RestartPolicy> RestartPolicy::create(Kind kind, unsigned interval, double growth, double margin) {
+    switch (kind) {
+        case NONE:
+            return std::make_unique<NoRestarts>();
+        case LUBY:
+            return std::make_unique<LubyRestarts>(interval);
+        case GEOMETRIC:
+            return std::make_unique<GeometricRestarts>(interval, growth);
+        case GLUCOSE:
+            return std::make_unique<GlucoseRestarts>(margin);
+    }
+    throw std::invalid_argument("Unknown restart policy");
+}
+
+
+uint64_t LubyRestarts::luby(uint64_t index) {
+    // find the finite subsequence 1 1 2 1 1 2 4 ... 2^(k-1) that contains index
+    uint64_t size = 1, power = 0;
+    while (size < index + 1) {
+        power++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != index) {
+        size = (size - 1) / 2;
+        power--;
+        index %= size;
+    }
+    return uint64_t(1) << power;
+}
+
+void LubyRestarts::restarted() {
+    index++;
+    conflicts = 0;
+}
+
+
+void GeometricRestarts::restarted() {
+    limit *= growth;
+    conflicts = 0;
+}
+
+
+void GlucoseRestarts::conflict(unsigned lbd) {
+    total_sum += lbd;
+    total_num++;
+    recent.push_back(lbd);
+    recent_sum += lbd;
+    if (recent.size() > window) {
+        recent_sum -= recent.front();
+        recent.pop_front();
+    }
+}
+
+bool GlucoseRestarts::should_restart() const {
+    if (recent.size() < window)
+        return false;
+    return double(recent_sum) / double(recent.size()) * margin > double(total_sum) / double(total_num);
+}
+
+void GlucoseRestarts::restarted() {
+    recent.clear();
+    recent_sum = 0;
+}
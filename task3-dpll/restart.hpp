@@ -0,0 +1,91 @@
+#ifndef TASK3_RESTART_HPP
+#define TASK3_RESTART_HPP
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+
+// Decides when the CDCL search drops all decisions and starts again from level 0,
+// keeping the learned clauses, activities and saved phases
+class RestartPolicy {
+
+public:
+    enum Kind {
+        NONE,
+        LUBY,      // interval times the Luby sequence 1 1 2 1 1 2 4 ... of conflicts
+        GEOMETRIC, // interval conflicts, then every next run growth times longer
+        GLUCOSE,   // when the recent learned clauses are much worse (by LBD) than the average
+    };
+
+    static std::unique_ptr<RestartPolicy> create(Kind kind, unsigned interval, double growth, double margin);
+    virtual ~RestartPolicy() = default;
+
+    virtual void conflict(unsigned lbd) = 0; // called once per learned clause with its LBD
+    [[nodiscard]] virtual bool should_restart() const = 0;
+    virtual void restarted() = 0;
+};
+
+
+class NoRestarts final : public RestartPolicy {
+
+public:
+    void conflict(unsigned /*lbd*/) override {}
+    [[nodiscard]] bool should_restart() const override { return false; }
+    void restarted() override {}
+};
+
+
+class LubyRestarts final : public RestartPolicy {
+
+public:
+    explicit LubyRestarts(unsigned interval): interval(interval), index(0), conflicts(0) {}
+
+    void conflict(unsigned /*lbd*/) override { conflicts++; }
+    [[nodiscard]] bool should_restart() const override { return conflicts >= interval * luby(index); }
+    void restarted() override;
+
+    static uint64_t luby(uint64_t index); // index-th element of the Luby sequence, starting from 0
+
+private:
+    unsigned interval;
+    uint64_t index;
+    uint64_t conflicts; // since the last restart
+};
+
+
+class GeometricRestarts final : public RestartPolicy {
+
+public:
+    GeometricRestarts(unsigned interval, double growth): limit(interval), growth(growth), conflicts(0) {}
+
+    void conflict(unsigned /*lbd*/) override { conflicts++; }
+    [[nodiscard]] bool should_restart() const override { return double(conflicts) >= limit; }
+    void restarted() override;
+
+private:
+    double limit;
+    double growth;
+    uint64_t conflicts; // since the last restart
+};
+
+
+class GlucoseRestarts final : public RestartPolicy {
+
+public:
+    explicit GlucoseRestarts(double margin, size_t window = 50): margin(margin), window(window) {}
+
+    void conflict(unsigned lbd) override;
+    [[nodiscard]] bool should_restart() const override;
+    void restarted() override;
+
+private:
+    double margin;    // restart if the recent average times margin exceeds the global one
+    size_t window;    // number of recent clauses
+    std::deque<unsigned> recent;
+    uint64_t recent_sum = 0;
+    uint64_t total_sum = 0;
+    uint64_t total_num = 0;
+};
+
+#endif //TASK3_RESTART_HPP
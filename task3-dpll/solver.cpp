@@ -0,0 +1,692 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "solver.hpp"
+
+
+Solver::Solver(const SolverConfig &config):
+        config(config), heuristic(Heuristic::create(config.heuristic, 0)),
+        restart_policy(RestartPolicy::create(config.restarts, config.restart_interval,
+                                             config.restart_growth, config.restart_margin)),
+        proof(nullptr), var_num(0), empty_clause_found(false), qhead(0), stamp(0), simplified_trail(0),
+        clause_increment(1), reduce_gap(config.reduce_interval), reduce_countdown(config.reduce_interval), learned_bytes(0), kept_bytes(0),
+        random(config.seed), stop(nullptr), exchange(nullptr), exchange_id(0), exchange_cursor(0),
+        start_time(std::chrono::steady_clock::now()), next_progress(config.progress_interval), progress_ticks(0) {
+    level_stamps.push_back(0);
+}
+
+Solver::Solver(const CNF &cnf, const SolverConfig &config, ProofWriter *proof): Solver(config) {
+    if (proof != nullptr and config.algorithm != CNF::CDCL)
+        throw std::invalid_argument("Only CDCL writes proofs");
+    this->proof = proof;
+    resize(cnf.num_vars());
+    if (!config.preprocess or config.algorithm != CNF::CDCL) {
+        load(cnf);
+        return;
+    }
+
+    ScopedTimer timer(statistics.preprocess_seconds);
+    preprocessor = std::make_unique<Preprocessor>(cnf, proof);
+    for (int var : config.frozen)
+        if (var > 0 and size_t(var) <= cnf.num_vars())
+            preprocessor->freeze(var - 1);
+    if (preprocessor->run())
+        load(preprocessor->simplified());
+    else
+        derive_empty_clause();
+}
+
+void Solver::load(const CNF &cnf) {
+    clauses.reserve(cnf.num_clauses(), cnf.get_clauses().used_bytes() / sizeof(int));
+
+    std::vector<int> literals;
+    for (auto clause : cnf.get_clauses()) {
+        literals.assign(clause.begin(), clause.end());
+        add_root_clause(literals);
+    }
+}
+
+void Solver::resize(size_t new_var_num) {
+    watches.resize(2 * new_var_num);
+    var_values.resize(new_var_num, BoolTernary::UNKNOWN);
+    levels.resize(new_var_num, 0);
+    reasons.resize(new_var_num, NO_CLAUSE);
+    seen.resize(new_var_num, false);
+    level_stamps.resize(new_var_num + 1, 0);
+    phases.resize(new_var_num, false);
+    if (config.seed != 0)
+        for (size_t var = var_num; var < new_var_num; var++)
+            phases[var] = random() & 1;
+    heuristic->resize(new_var_num);
+    var_num = new_var_num;
+}
+
+void Solver::restore_eliminated(const std::vector<int> &literals) {
+    if (preprocessor == nullptr)
+        return;
+    std::vector<size_t> vars;
+    for (int literal : literals)
+        if (size_t(abs(literal)) <= preprocessor->num_vars() and preprocessor->is_eliminated(abs(literal) - 1))
+            vars.push_back(abs(literal) - 1);
+    if (vars.empty())
+        return;
+
+    // the clauses come back as they were in the original formula (or implied by it, for the units)
+    cancel_until(0);
+    for (auto &[witness, clause] : preprocessor->restore(vars)) {
+        if (proof != nullptr) {
+            // the removed variable goes first, the clause is RAT on it
+            std::iter_swap(clause.begin(), std::find(clause.begin(), clause.end(), witness));
+            proof->add(clause);
+        }
+        add_root_clause(clause);
+    }
+}
+
+void Solver::add_clause(const std::vector<int> &clause) {
+    restore_eliminated(clause);
+    cancel_until(0);
+    std::vector<int> literals(clause);
+    for (int literal : literals)
+        if (size_t(abs(literal)) > var_num)
+            resize(abs(literal));
+    add_root_clause(literals);
+}
+
+void Solver::add_root_clause(std::vector<int> &clause) {
+    // duplicate literals would break the watching scheme, tautologies are always true
+    std::sort(clause.begin(), clause.end());
+    clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+    for (int literal : clause)
+        if (std::binary_search(clause.begin(), clause.end(), -literal) or get_value(literal) == BoolTernary::TRUE)
+            return;
+    size_t size = clause.size();
+    clause.erase(std::remove_if(clause.begin(), clause.end(), [this](int literal) {
+        return get_value(literal) == BoolTernary::FALSE;
+    }), clause.end());
+
+    if (clause.empty()) {
+        derive_empty_clause();
+        return;
+    }
+    if (proof != nullptr and clause.size() < size)
+        proof->add(clause);
+
+    if (clause.size() == 1) {
+        BoolTernary value = get_value(clause[0]);
+        if (value == BoolTernary::FALSE)
+            derive_empty_clause();
+        else if (value == BoolTernary::UNKNOWN)
+            assign(clause[0], NO_CLAUSE);
+        return;
+    }
+
+    store(clause, false);
+}
+
+void Solver::derive_empty_clause() {
+    if (proof != nullptr and !empty_clause_found)
+        proof->add(std::vector<int>());
+    empty_clause_found = true;
+}
+
+ClauseRef Solver::store(const std::vector<int> &clause, bool learnt) {
+    ClauseRef ref = clauses.alloc(clause.data(), clause.size(), learnt);
+    watches[lit_index(clause[0])].push_back(ref);
+    watches[lit_index(clause[1])].push_back(ref);
+    return ref;
+}
+
+
+CNF::BoolTernary Solver::get_value(int literal) const {
+    BoolTernary value = var_values[abs(literal) - 1];
+    if (literal > 0 or value == BoolTernary::UNKNOWN)
+        return value;
+    return value == BoolTernary::TRUE ? BoolTernary::FALSE : BoolTernary::TRUE;
+}
+
+void Solver::assign(int literal, ClauseRef reason) {
+    size_t index = abs(literal) - 1;
+    var_values[index] = literal > 0 ? BoolTernary::TRUE : BoolTernary::FALSE;
+    levels[index] = decision_level();
+    reasons[index] = reason;
+    trail.push_back(literal);
+}
+
+
+ClauseRef Solver::propagate() {
+    // every clause watches its first two literals, so only the clauses watching
+    // the literal that has just become false have to be visited;
+    // an implied literal is always moved to the first position of its reason
+    while (qhead < trail.size()) {
+        int false_literal = -trail[qhead++];
+        statistics.propagations++;
+        auto &watch_list = watches[lit_index(false_literal)];
+
+        size_t i = 0, j = 0;
+        while (i < watch_list.size()) {
+            ClauseRef ref = watch_list[i++];
+            Clause clause = clauses[ref];
+            if (clause[0] == false_literal)
+                std::swap(clause[0], clause[1]);
+
+            if (get_value(clause[0]) == BoolTernary::TRUE) {
+                watch_list[j++] = ref;
+                continue;
+            }
+
+            // look for a new literal to watch instead of the false one
+            bool moved = false;
+            for (size_t k = 2; k < clause.size() and !moved; k++) {
+                if (get_value(clause[k]) != BoolTernary::FALSE) {
+                    std::swap(clause[1], clause[k]);
+                    watches[lit_index(clause[1])].push_back(ref);
+                    moved = true;
+                }
+            }
+            if (moved)
+                continue;
+
+            watch_list[j++] = ref;
+            if (get_value(clause[0]) == BoolTernary::FALSE) {
+                while (i < watch_list.size())
+                    watch_list[j++] = watch_list[i++];
+                watch_list.resize(j);
+                qhead = trail.size();
+                return ref;
+            }
+            assign(clause[0], ref);
+        }
+        watch_list.resize(j);
+    }
+    return NO_CLAUSE;
+}
+
+void Solver::cancel_until(size_t level) {
+    while (decision_level() > level) {
+        while (trail.size() > trail_lim.back()) {
+            size_t var = abs(trail.back()) - 1;
+            if (config.phase_saving)
+                phases[var] = trail.back() > 0;
+            var_values[var] = BoolTernary::UNKNOWN;
+            heuristic->unassigned(var);
+            trail.pop_back();
+        }
+        trail_lim.pop_back();
+        flipped.pop_back();
+    }
+    qhead = std::min(qhead, trail.size());
+}
+
+bool Solver::roll_back() {
+    while (decision_level() > 0 and flipped.back())
+        cancel_until(decision_level() - 1);
+
+    if (decision_level() == 0)
+        return false;
+
+    int decision = trail[trail_lim.back()];
+    cancel_until(decision_level() - 1);
+    trail_lim.push_back(trail.size());
+    flipped.push_back(true);
+    assign(-decision, NO_CLAUSE);
+    statistics.backtracks++;
+    return true;
+}
+
+size_t Solver::analyze(ClauseRef conflict, std::vector<int> &learnt) {
+    // resolve the conflict clause with the reasons of the current level literals
+    // in reverse trail order until only the first unique implication point is left
+    learnt.assign(1, 0);
+    size_t counter = 0;
+    size_t index = trail.size();
+    ClauseRef reason = conflict;
+    int literal = 0;
+
+    do {
+        if (clauses[reason].learnt())
+            bump_clause(reason);
+        ConstClause clause = std::as_const(clauses)[reason];
+        for (size_t i = literal == 0 ? 0 : 1; i < clause.size(); i++) {
+            size_t var = abs(clause[i]) - 1;
+            if (seen[var] or levels[var] == 0)
+                continue;
+            seen[var] = true;
+            heuristic->bump(var);
+            if (levels[var] == decision_level())
+                counter++;
+            else
+                learnt.push_back(clause[i]);
+        }
+
+        while (!seen[abs(trail[--index]) - 1]);
+        literal = trail[index];
+        reason = reasons[abs(literal) - 1];
+        seen[abs(literal) - 1] = false;
+        counter--;
+    } while (counter > 0);
+    learnt[0] = -literal;
+
+    // the literal of the highest remaining level is watched together with the asserting one
+    size_t backjump_level = 0;
+    for (size_t i = 1; i < learnt.size(); i++) {
+        seen[abs(learnt[i]) - 1] = false;
+        if (levels[abs(learnt[i]) - 1] > backjump_level) {
+            backjump_level = levels[abs(learnt[i]) - 1];
+            std::swap(learnt[1], learnt[i]);
+        }
+    }
+    return backjump_level;
+}
+
+bool Solver::learn(ClauseRef conflict) {
+    if (decision_level() == 0)
+        return false;
+
+    std::vector<int> learnt;
+    size_t backjump_level = analyze(conflict, learnt);
+    heuristic->decay();
+    unsigned lbd = compute_lbd(learnt.data(), learnt.data() + learnt.size());
+    restart_policy->conflict(lbd);
+    clause_increment /= 0.999f;
+    cancel_until(backjump_level);
+    statistics.backtracks++;
+    statistics.learned_clauses++;
+    statistics.learned_literals += learnt.size();
+
+    if (exchange != nullptr)
+        exchange->publish(exchange_id, learnt);
+    if (proof != nullptr)
+        proof->add(learnt);
+
+    if (learnt.size() == 1) {
+        assign(learnt[0], NO_CLAUSE);
+        return true;
+    }
+    ClauseRef ref = store(learnt, true);
+    clauses[ref].set_lbd(lbd);
+    clauses[ref].set_activity(clause_increment);
+    learned_bytes += (Clause::HEADER_WORDS + learnt.size()) * sizeof(int);
+    statistics.learned_bytes.raise_to(learned_bytes);
+    assign(learnt[0], ref);
+    return true;
+}
+
+
+unsigned Solver::compute_lbd(const int *begin, const int *end) {
+    stamp++;
+    unsigned lbd = 0;
+    for (const int *literal = begin; literal != end; literal++) {
+        size_t level = levels[abs(*literal) - 1];
+        if (level_stamps[level] != stamp) {
+            level_stamps[level] = stamp;
+            lbd++;
+        }
+    }
+    return lbd;
+}
+
+void Solver::analyze_final(int literal) {
+    // walk the trail back from literal, every decision reached on the way is an assumption
+    failed.assign(1, literal);
+    if (decision_level() == 0)
+        return;
+
+    seen[abs(literal) - 1] = true;
+    for (size_t i = trail.size(); i > trail_lim[0]; i--) {
+        size_t var = abs(trail[i - 1]) - 1;
+        if (!seen[var])
+            continue;
+        if (reasons[var] == NO_CLAUSE) {
+            failed.push_back(trail[i - 1]);
+        } else {
+            for (int other : std::as_const(clauses)[reasons[var]])
+                if (levels[abs(other) - 1] > 0)
+                    seen[abs(other) - 1] = true;
+        }
+        seen[var] = false;
+    }
+    seen[abs(literal) - 1] = false;
+}
+
+void Solver::restart() {
+    cancel_until(0);
+    restart_policy->restarted();
+    statistics.restarts++;
+}
+
+
+void Solver::report_progress() {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (seconds < next_progress)
+        return;
+    next_progress = seconds + config.progress_interval;
+
+    std::cerr << "c " << std::fixed << std::setprecision(1) << seconds << "s"
+              << " conflicts " << statistics.conflicts
+              << " decisions " << statistics.decisions
+              << " propagations/s " << std::setprecision(0) << double(statistics.propagations) / seconds
+              << " restarts " << statistics.restarts
+              << " learned " << statistics.learned_clauses << " (" << learned_bytes / 1024 << " KB)"
+              << " level-0 vars " << (decision_level() == 0 ? trail.size() : trail_lim[0]) << "/" << var_num
+              << " clauses " << clauses.used_bytes() / 1024 << " KB" << std::defaultfloat << std::endl;
+}
+
+
+void Solver::share_clauses(ClauseExchange *shared, size_t id) {
+    // the imported clauses do not follow from the clauses of the proof
+    if (proof != nullptr)
+        throw std::invalid_argument("Shared clauses can not be written to a proof");
+    exchange = shared;
+    exchange_id = id;
+}
+
+void Solver::import_shared_clauses() {
+    std::vector<std::vector<int>> imported;
+    exchange->collect(exchange_id, exchange_cursor, imported);
+    for (auto &clause : imported)
+        add_root_clause(clause);
+}
+
+
+void Solver::simplify() {
+    ScopedTimer timer(statistics.simplify_seconds);
+    // clauses satisfied at level 0 stay satisfied for the rest of the search;
+    // the proof keeps the units instead of their reasons
+    if (proof != nullptr)
+        for (size_t i = simplified_trail; i < trail.size(); i++)
+            proof->add(&trail[i], &trail[i] + 1);
+
+    const ClauseArena &arena = clauses;
+    for (auto it = arena.begin(); it != arena.end(); ++it) {
+        for (int literal : *it) {
+            if (get_value(literal) == BoolTernary::TRUE) {
+                if (proof != nullptr)
+                    proof->remove((*it).begin(), (*it).end());
+                free_clause(it.get_ref());
+                statistics.deleted_clauses++;
+                break;
+            }
+        }
+    }
+
+    detach_deleted();
+    simplified_trail = trail.size();
+}
+
+void Solver::free_clause(ClauseRef ref) {
+    if (clauses[ref].deleted())
+        return;
+    if (clauses[ref].learnt())
+        learned_bytes -= (Clause::HEADER_WORDS + clauses[ref].size()) * sizeof(int);
+    clauses.free(ref);
+}
+
+void Solver::detach_deleted() {
+    const ClauseArena &arena = clauses;
+    for (auto &watch_list : watches) {
+        watch_list.erase(std::remove_if(watch_list.begin(), watch_list.end(), [&](ClauseRef ref) {
+            return arena[ref].deleted();
+        }), watch_list.end());
+    }
+    if (clauses.wasted_bytes() > clauses.used_bytes() / 4)
+        collect_garbage();
+}
+
+void Solver::collect_garbage() {
+    Relocation relocation = clauses.compact();
+    for (auto &watch_list : watches)
+        for (auto &ref : watch_list)
+            ref = relocation(ref);
+    for (int literal : trail) {
+        auto &reason = reasons[abs(literal) - 1];
+        if (reason != NO_CLAUSE)
+            reason = relocation(reason);
+    }
+}
+
+
+void Solver::bump_clause(ClauseRef ref) {
+    Clause clause = clauses[ref];
+    clause.set_used(true);
+    // the clause may have become better than when it was learned, tier2 ones may move to the core
+    if (clause.lbd() > config.core_lbd) {
+        unsigned lbd = compute_lbd(clause.begin(), clause.end());
+        if (lbd < clause.lbd())
+            clause.set_lbd(lbd);
+    }
+    clause.set_activity(clause.activity() + clause_increment);
+    if (clause.activity() > 1e20f) {
+        const ClauseArena &arena = clauses;
+        for (auto it = arena.begin(); it != arena.end(); ++it)
+            if ((*it).learnt())
+                clauses[it.get_ref()].set_activity((*it).activity() * 1e-20f);
+        clause_increment *= 1e-20f;
+    }
+}
+
+bool Solver::locked(ClauseRef ref) const {
+    int literal = std::as_const(clauses)[ref][0];
+    return get_value(literal) == BoolTernary::TRUE and reasons[abs(literal) - 1] == ref;
+}
+
+void Solver::reduce_db(size_t max_bytes) {
+    ScopedTimer timer(statistics.simplify_seconds);
+    statistics.reductions++;
+    const ClauseArena &arena = clauses;
+    std::vector<ClauseRef> candidates; // local and unused tier2 clauses
+    std::vector<ClauseRef> used;       // tier2 clauses used since the last reduction
+    kept_bytes = 0;
+    for (auto it = arena.begin(); it != arena.end(); ++it) {
+        ConstClause clause = *it;
+        if (!clause.learnt())
+            continue;
+        if (clause.lbd() <= config.core_lbd or locked(it.get_ref())) {
+            kept_bytes += (Clause::HEADER_WORDS + clause.size()) * sizeof(int);
+            continue;
+        }
+        if (clause.lbd() <= config.tier2_lbd and clause.used())
+            used.push_back(it.get_ref());
+        else
+            candidates.push_back(it.get_ref());
+        clauses[it.get_ref()].set_used(false);
+    }
+    // the less active first, of the same activity the ones of larger LBD
+    auto less_useful = [&arena](ClauseRef a, ClauseRef b) {
+        if (arena[a].activity() != arena[b].activity())
+            return arena[a].activity() < arena[b].activity();
+        return arena[a].lbd() > arena[b].lbd();
+    };
+    std::sort(candidates.begin(), candidates.end(), less_useful);
+    std::sort(used.begin(), used.end(), less_useful);
+    size_t half = candidates.size() / 2;
+    candidates.insert(candidates.end(), used.begin(), used.end());
+
+    for (size_t i = 0; i < candidates.size() and (i < half or learned_bytes - kept_bytes > max_bytes); i++) {
+        if (proof != nullptr)
+            proof->remove(arena[candidates[i]].begin(), arena[candidates[i]].end());
+        free_clause(candidates[i]);
+        statistics.reduced_clauses++;
+    }
+    detach_deleted();
+}
+
+size_t Solver::memory_bytes() const {
+    size_t bytes = clauses.memory_bytes();
+    for (const auto &watch_list : watches)
+        bytes += watch_list.capacity() * sizeof(ClauseRef) + sizeof(watch_list);
+    bytes += var_num * (sizeof(BoolTernary) + sizeof(size_t) + sizeof(ClauseRef) + sizeof(uint64_t));
+    bytes += (trail.capacity() + assumptions.capacity() + failed.capacity()) * sizeof(int);
+    return bytes;
+}
+
+
+size_t Solver::pick_branch_var() {
+    if (config.random_var_freq > 0 and std::uniform_real_distribution<>(0, 1)(random) < config.random_var_freq) {
+        size_t var = random() % var_num;
+        if (var_values[var] == BoolTernary::UNKNOWN)
+            return var;
+    }
+    return heuristic->pick(var_values);
+}
+
+
+bool Solver::solve() {
+    return solve(std::vector<int>());
+}
+
+bool Solver::solve(const std::vector<int> &assumed) {
+    std::atomic<bool> never(false);
+    return solve(assumed, never) == BoolTernary::TRUE;
+}
+
+CNF::BoolTernary Solver::solve(const std::vector<int> &assumed, const std::atomic<bool> &stop_flag) {
+    ScopedTimer timer(statistics.solve_seconds);
+    restore_eliminated(assumed);
+    cancel_until(0);
+    for (int literal : assumed)
+        if (size_t(abs(literal)) > var_num)
+            resize(abs(literal));
+    assumptions = assumed;
+    failed.clear();
+    stop = &stop_flag;
+
+    BoolTernary result = search();
+    stop = nullptr;
+    return result;
+}
+
+bool Solver::lookahead(const std::vector<int> &literals, std::vector<int> &implied) {
+    restore_eliminated(literals);
+    cancel_until(0);
+    for (int literal : literals)
+        if (size_t(abs(literal)) > var_num)
+            resize(abs(literal));
+
+    bool consistent = !empty_clause_found and propagate() == NO_CLAUSE;
+    if (!consistent)
+        derive_empty_clause();
+    for (size_t i = 0; i < literals.size() and consistent; i++) {
+        BoolTernary value = get_value(literals[i]);
+        if (value == BoolTernary::UNKNOWN) {
+            new_decision_level(true);
+            assign(literals[i], NO_CLAUSE);
+            consistent = propagate() == NO_CLAUSE;
+        } else {
+            consistent = value == BoolTernary::TRUE;
+        }
+    }
+    implied = trail;
+    cancel_until(0);
+    return consistent;
+}
+
+std::vector<bool> Solver::model() const {
+    std::vector<bool> values(var_num);
+    for (size_t var = 0; var < var_num; var++)
+        values[var] = var_values[var] == BoolTernary::TRUE;
+    if (preprocessor != nullptr)
+        preprocessor->extend_model(values);
+    return values;
+}
+
+void Solver::new_decision_level(bool is_assumption) {
+    trail_lim.push_back(trail.size());
+    // DPLL must not try the negation of an assumption
+    flipped.push_back(is_assumption);
+    // assumptions already true open empty levels, so there may be more levels than variables
+    if (level_stamps.size() <= decision_level())
+        level_stamps.resize(2 * decision_level(), 0);
+}
+
+CNF::BoolTernary Solver::search() {
+    while (true) {
+        if (empty_clause_found)
+            return BoolTernary::FALSE;
+        if (stop != nullptr and stop->load(std::memory_order_relaxed))
+            return BoolTernary::UNKNOWN;
+
+        ClauseRef conflict;
+        {
+            DetailedTimer timer(statistics.propagate_seconds);
+            conflict = propagate();
+        }
+        if (conflict != NO_CLAUSE) {
+            statistics.conflicts++;
+            if (config.progress_interval > 0 and (++progress_ticks & 1023) == 0)
+                report_progress();
+            if (decision_level() == 0) {
+                derive_empty_clause();
+                return BoolTernary::FALSE;
+            }
+
+            bool resolved;
+            if (config.algorithm == CNF::CDCL) {
+                DetailedTimer timer(statistics.analyze_seconds);
+                resolved = learn(conflict);
+            } else {
+                for (int literal : clauses[conflict])
+                    heuristic->bump(abs(literal) - 1);
+                heuristic->decay();
+                resolved = roll_back();
+            }
+            if (!resolved) {
+                // DPLL ran out of decisions above the assumptions
+                failed = assumptions;
+                return BoolTernary::FALSE;
+            }
+            if (config.algorithm == CNF::CDCL) {
+                if (--reduce_countdown == 0) {
+                    reduce_gap += config.reduce_increment;
+                    reduce_countdown = reduce_gap;
+                    reduce_db(SIZE_MAX);
+                } else if (config.memory_budget > 0 and learned_bytes > kept_bytes + config.memory_budget) {
+                    // the clauses that can not be deleted would trigger a reduction on every conflict
+                    reduce_db(config.memory_budget / 2);
+                }
+                if (restart_policy->should_restart())
+                    restart();
+            }
+            continue;
+        }
+
+        if (decision_level() == 0 and exchange != nullptr) {
+            size_t trail_size = trail.size();
+            import_shared_clauses();
+            if (empty_clause_found or trail.size() > trail_size)
+                continue;
+        }
+        if (decision_level() == 0 and trail.size() > simplified_trail)
+            simplify();
+
+        int decision = 0;
+        while (decision == 0 and decision_level() < assumptions.size()) {
+            int literal = assumptions[decision_level()];
+            BoolTernary value = get_value(literal);
+            if (value == BoolTernary::FALSE) {
+                analyze_final(literal);
+                return BoolTernary::FALSE;
+            }
+            if (value == BoolTernary::TRUE)
+                new_decision_level(true); // keeps the levels of the assumptions aligned
+            else
+                decision = literal;
+        }
+
+        bool is_assumption = decision != 0;
+        if (decision == 0) {
+            size_t var = pick_branch_var();
+            if (var == var_num)
+                return BoolTernary::TRUE;
+            decision = phases[var] ? int(var + 1) : -int(var + 1);
+        }
+
+        statistics.decisions++;
+        new_decision_level(is_assumption);
+        statistics.max_level.raise_to(decision_level());
+        assign(decision, NO_CLAUSE);
+    }
+}
@@ -0,0 +1,184 @@
+#ifndef TASK3_SOLVER_HPP
+#define TASK3_SOLVER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include "clause_exchange.hpp"
+#include "cnf.hpp"
+#include "heuristic.hpp"
+#include "preprocessor.hpp"
+#include "proof.hpp"
+#include "restart.hpp"
+#include "stats.hpp"
+
+
+struct SolverConfig {
+    CNF::Algorithm algorithm = CNF::CDCL;
+    Heuristic::Kind heuristic = Heuristic::VSIDS;
+    bool phase_saving = true;    // branch on the last value of a variable instead of always FALSE
+    unsigned seed = 0;           // nonzero seeds start from random phases
+    double random_var_freq = 0;  // probability to branch on a random variable
+
+    // restarts are used by CDCL only, DPLL has to keep its decisions to stay complete
+    RestartPolicy::Kind restarts = RestartPolicy::GLUCOSE;
+    unsigned restart_interval = 100; // conflicts in the first run for LUBY and GEOMETRIC
+    double restart_growth = 1.5;     // GEOMETRIC: growth of the runs
+    double restart_margin = 0.8;     // GLUCOSE: how much the recent clauses must be worse than average
+
+    // CDCL keeps the learned clauses of LBD <= core_lbd (core) forever and the ones of LBD <= tier2_lbd
+    // while they take part in conflicts; the other (local) ones are halved by activity every
+    // reduce_interval conflicts, the interval growing by reduce_increment after each reduction
+    unsigned core_lbd = 2;
+    unsigned tier2_lbd = 6;
+    unsigned reduce_interval = 2000;
+    unsigned reduce_increment = 300;
+    size_t memory_budget = 0; // bytes of deletable learned clauses that force a reduction down to half of it, 0 - no limit
+
+    // CDCL simplifies the formula given to the constructor; an eliminated variable used later
+    // in a clause, an assumption or a lookahead gets its removed clauses back, frozen variables
+    // (numbered from 1) are never eliminated and save that work for the ones known in advance;
+    // DPLL keeps the original formula, where the static variable order works much better
+    bool preprocess = true;
+    std::vector<int> frozen;
+
+    // CNF::is_sat runs DPLL on formulas of at most 64 variables with BitDpll,
+    // which evaluates all clauses at once on bitmasks
+    bool bit_parallel = true;
+    // CNF::is_sat runs ProbSAT local search alongside the solver (never BitDpll) and takes the first answer
+    bool local_search = false;
+
+    double progress_interval = 0; // seconds between the progress lines written to std::cerr, 0 - none
+};
+
+
+// DPLL/CDCL search over a CNF formula with two-watched-literal unit propagation
+class Solver {
+
+public:
+    explicit Solver(const SolverConfig &config = SolverConfig()); // empty formula, clauses are added later
+    // CDCL can write a DRAT proof of the formula given here: the learned clauses,
+    // the clauses derived by the preprocessor and the deletions
+    explicit Solver(const CNF &cnf, const SolverConfig &config = SolverConfig(), ProofWriter *proof = nullptr);
+
+    // Clauses may be added between the calls of solve, the learned clauses, activities
+    // and phases are kept. New variables are created for literals out of the range.
+    void add_clause(const std::vector<int> &clause);
+    [[nodiscard]] size_t num_vars() const { return var_num; }
+
+    [[nodiscard]] bool solve(); // checking the satisfiability of the formula
+    // checking the satisfiability under the assumption that the given literals are true
+    [[nodiscard]] bool solve(const std::vector<int> &assumptions);
+    // the same, but gives up with UNKNOWN as soon as stop is raised by another thread
+    [[nodiscard]] CNF::BoolTernary solve(const std::vector<int> &assumptions, const std::atomic<bool> &stop);
+    // assumptions that are enough for the last solve to be unsatisfiable,
+    // empty if the formula is unsatisfiable by itself
+    [[nodiscard]] const std::vector<int>& failed_assumptions() const { return failed; }
+    // satisfying assignment found by the last solve, model[var] is the value of the variable var + 1
+    [[nodiscard]] std::vector<bool> model() const;
+
+    // assigns the literals one decision level each and propagates them without any search,
+    // implied gets every assigned literal (the level 0 ones included); returns false on a conflict
+    [[nodiscard]] bool lookahead(const std::vector<int> &literals, std::vector<int> &implied);
+
+    // publishes short learned clauses to the exchange and imports the ones of other solvers
+    void share_clauses(ClauseExchange *exchange, size_t id);
+
+    [[nodiscard]] const SolverStats& stats() const { return statistics; }
+    [[nodiscard]] size_t memory_bytes() const; // clauses, watches and the per-variable data
+    [[nodiscard]] size_t learned_clause_bytes() const { return learned_bytes; }
+    [[nodiscard]] const Preprocessor* get_preprocessor() const { return preprocessor.get(); }
+
+private:
+    using BoolTernary = CNF::BoolTernary;
+    static constexpr ClauseRef NO_CLAUSE = ClauseArena::NO_CLAUSE;
+
+    SolverConfig config;
+    SolverStats statistics;
+    std::unique_ptr<Heuristic> heuristic;
+    std::unique_ptr<RestartPolicy> restart_policy;
+    std::unique_ptr<Preprocessor> preprocessor;  // keeps the eliminated clauses to extend the model
+    ProofWriter *proof;
+    size_t var_num;
+    bool empty_clause_found;
+    ClauseArena clauses;                         // original clauses followed by the learned ones
+
+    std::vector<std::vector<ClauseRef>> watches; // clauses watching each literal, indexed by lit_index
+    std::vector<BoolTernary> var_values;
+    std::vector<size_t> levels;                  // decision level of each assigned variable
+    std::vector<ClauseRef> reasons;              // clause that implied each variable, NO_CLAUSE for decisions
+    std::vector<int> trail;                      // assigned literals in the order of assignment
+    std::vector<size_t> trail_lim;               // trail size at the start of each decision level
+    std::vector<bool> flipped;                   // whether the decision of each level was already flipped
+    size_t qhead;                                // first literal of the trail that was not propagated yet
+    std::vector<bool> seen;                      // variables marked during conflict analysis
+    std::vector<uint64_t> level_stamps;          // used to count the distinct levels of a clause
+    uint64_t stamp;
+    std::vector<bool> phases;                    // saved value of each variable, true for TRUE
+    size_t simplified_trail;                     // level 0 trail size at the last simplification
+    float clause_increment;                      // activity bump of the learned clauses, grows after every conflict
+    uint64_t reduce_gap;                         // conflicts between the last reduction and the next one
+    uint64_t reduce_countdown;
+    size_t learned_bytes;                        // arena memory of the live learned clauses
+    size_t kept_bytes;                           // of them core and locked at the last reduction, not counted in the budget
+    std::mt19937 random;
+
+    std::vector<int> assumptions;                // decisions of the first levels
+    std::vector<int> failed;                     // subset of assumptions that made the last solve fail
+    const std::atomic<bool> *stop;
+    ClauseExchange *exchange;
+    size_t exchange_id;
+    uint64_t exchange_cursor;
+    std::chrono::steady_clock::time_point start_time;
+    double next_progress;                        // seconds since start_time
+    uint64_t progress_ticks;
+
+    static size_t lit_index(int literal) { return 2 * (abs(literal) - 1) + (literal < 0); }
+    [[nodiscard]] BoolTernary get_value(int literal) const;
+    [[nodiscard]] size_t decision_level() const { return trail_lim.size(); }
+
+    void resize(size_t new_var_num);
+    void load(const CNF &cnf);
+    void restore_eliminated(const std::vector<int> &literals);
+    [[nodiscard]] BoolTernary search();
+    [[nodiscard]] size_t pick_branch_var();
+    void new_decision_level(bool is_assumption);
+
+    void add_root_clause(std::vector<int> &clause); // only at level 0
+    void derive_empty_clause();
+    void import_shared_clauses();
+    ClauseRef store(const std::vector<int> &clause, bool learnt); // allocates and watches the clause
+    void assign(int literal, ClauseRef reason);
+    [[nodiscard]] ClauseRef propagate(); // returns the clause that became false or NO_CLAUSE
+    void cancel_until(size_t level);
+
+    // removes the clauses satisfied at level 0 and compacts the arena once enough memory is wasted
+    void simplify();
+    void collect_garbage();
+
+    // DPLL: flips the last not flipped decision, returns false if there is none
+    [[nodiscard]] bool roll_back();
+    // CDCL: learns the 1-UIP clause of the conflict and backjumps to its asserting level,
+    // returns false if the conflict does not depend on any decision
+    [[nodiscard]] bool learn(ClauseRef conflict);
+    size_t analyze(ClauseRef conflict, std::vector<int> &learnt);
+    void analyze_final(int literal); // collects the assumptions that imply the negation of literal
+    unsigned compute_lbd(const int *begin, const int *end); // number of distinct decision levels
+
+    // learned clause database
+    void bump_clause(ClauseRef ref); // the learned clause took part in a conflict
+    [[nodiscard]] bool locked(ClauseRef ref) const; // the clause is the reason of its first literal
+    // deletes the less active half of the local and unused tier2 clauses,
+    // then more of them (used ones last) while the deletable learned clauses take more than max_bytes
+    void reduce_db(size_t max_bytes);
+    void free_clause(ClauseRef ref);
+    void detach_deleted(); // removes the deleted clauses from the watch lists
+    void restart();
+    void report_progress();
+};
+
+#endif //TASK3_SOLVER_HPP
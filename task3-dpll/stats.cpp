@@ -0,0 +1,22 @@
+#include "stats.hpp"
+
+
+void SolverStats::write_json(std::ostream &out) const {
+    out << "{\"decisions\": " << decisions
+        << ", \"propagations\": " << propagations
+        << ", \"conflicts\": " << conflicts
+        << ", \"restarts\": " << restarts
+        << ", \"backtracks\": " << backtracks
+        << ", \"learned_clauses\": " << learned_clauses
+        << ", \"learned_literals\": " << learned_literals
+        << ", \"deleted_clauses\": " << deleted_clauses
+        << ", \"reductions\": " << reductions
+        << ", \"reduced_clauses\": " << reduced_clauses
+        << ", \"learned_bytes\": " << learned_bytes
+        << ", \"max_level\": " << max_level
+        << ", \"preprocess_sec\": " << preprocess_seconds
+        << ", \"propagate_sec\": " << propagate_seconds
+        << ", \"analyze_sec\": " << analyze_seconds
+        << ", \"simplify_sec\": " << simplify_seconds
+        << ", \"solve_sec\": " << solve_seconds << "}";
+}
@@ -0,0 +1,91 @@
+#ifndef TASK3_STATS_HPP
+#define TASK3_STATS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// the counters and timers compile to nothing with -DTASK3_STATS=0; the time of every propagation
+// and conflict analysis is measured only with -DTASK3_STATS=2, reading the clock there slows the search
+#ifndef TASK3_STATS
+#define TASK3_STATS 1
+#endif
+
+
+class Counter {
+
+public:
+    static constexpr bool ENABLED = TASK3_STATS >= 1;
+    static constexpr bool DETAILED = TASK3_STATS >= 2;
+
+    Counter& operator ++() {
+        if constexpr (ENABLED)
+            value++;
+        return *this;
+    }
+    void operator ++(int) { ++*this; }
+    Counter& operator +=(uint64_t amount) {
+        if constexpr (ENABLED)
+            value += amount;
+        return *this;
+    }
+    void raise_to(uint64_t amount) { // keeps the maximum
+        if constexpr (ENABLED)
+            value = amount > value ? amount : value;
+    }
+    operator uint64_t() const { return value; }
+
+private:
+    uint64_t value = 0;
+};
+
+
+// adds the wall time of its scope to the given number of seconds
+template <bool ENABLED>
+class BasicScopedTimer {
+
+public:
+    explicit BasicScopedTimer(double &seconds): seconds(seconds) {
+        if constexpr (ENABLED)
+            start = std::chrono::steady_clock::now();
+    }
+    ~BasicScopedTimer() {
+        if constexpr (ENABLED)
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    BasicScopedTimer(const BasicScopedTimer &) = delete;
+    BasicScopedTimer& operator =(const BasicScopedTimer &) = delete;
+
+private:
+    double &seconds;
+    std::chrono::steady_clock::time_point start;
+};
+
+using ScopedTimer = BasicScopedTimer<Counter::ENABLED>;
+using DetailedTimer = BasicScopedTimer<Counter::DETAILED>; // for the scopes entered on every conflict
+
+
+struct SolverStats {
+    Counter decisions;
+    Counter propagations;     // assigned literals taken from the propagation queue
+    Counter conflicts;
+    Counter restarts;
+    Counter backtracks;       // DPLL flips and CDCL backjumps
+    Counter learned_clauses;
+    Counter learned_literals;
+    Counter deleted_clauses;  // satisfied at level 0
+    Counter reductions;       // of the learned clause database
+    Counter reduced_clauses;  // learned clauses deleted by the reductions
+    Counter learned_bytes;    // peak arena memory of the learned clauses
+    Counter max_level;        // deepest decision level reached
+
+    double preprocess_seconds = 0;
+    double propagate_seconds = 0; // with TASK3_STATS=2 only, like analyze_seconds
+    double analyze_seconds = 0;   // conflict analysis and backjumping
+    double simplify_seconds = 0;  // level 0 simplification and learned clause reduction
+    double solve_seconds = 0;     // all calls of solve
+
+    void write_json(std::ostream &out) const; // one object on one line
+};
+
+#endif //TASK3_STATS_HPP
@@ -1,27 +1,556 @@
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
-#include <ctime>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+#include "batch.hpp"
+#include "binary_cnf.hpp"
+#include "bit_dpll.hpp"
+#include "checker.hpp"
+#include "cube_and_conquer.hpp"
 #include "cnf.hpp"
+#include "dimacs.hpp"
+#include "generator.hpp"
+#include "input_stream.hpp"
+#include "local_search.hpp"
+#include "portfolio.hpp"
+#include "preprocessor.hpp"
+#include "proof.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
 
 
-void test_directory(std::string path, int n1, int n2, bool is_sat, std::string test_name) {
-    clock_t t_start = clock();
+void test_directory(std::string path, int n1, int n2, bool is_sat, std::string test_name,
+                    const std::function<bool(const CNF &)> &solve) {
+    auto t_start = std::chrono::steady_clock::now();
     for (int i = n1; i <= n2; i++) {
         std::string full_path = path + std::to_string(i) + ".cnf";
-        std::ifstream fin(full_path);
-        CNF cnf(fin);
-        assert(cnf.is_sat() == is_sat);
+        CNF cnf(full_path);
+        assert(solve(cnf) == is_sat);
     }
-    clock_t t_end = clock();
-    double time = double(t_end - t_start) / CLOCKS_PER_SEC;
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - t_start;
+    double time = seconds.count();
     std::cout << test_name << ": " << time << " sec (" << (time / (n2 - n1 + 1) ) << " sec per iteration)" << std::endl;
 }
 
+void test_parser() {
+    std::ifstream fin("data/hanoi/hanoi4.cnf");
+    CNF streamed(fin);
+    CNF mapped("data/hanoi/hanoi4.cnf");
+    assert(streamed.get_clauses() == mapped.get_clauses());
+    std::cout << "hanoi parsing: " << mapped.parse_throughput() << " MB/s" << std::endl;
+
+    const char *text = "c clauses over several lines\np cnf 3 2\n1 -2\n 3 0 -1\n0\n";
+    DimacsData data;
+    parse_dimacs(text, text + strlen(text), data);
+    assert(data.clauses_read == 2);
+    assert(data.literals == std::vector<int>({1, -2, 3, 0, -1, 0}));
+
+    // the stream parser checks the variables against the header like the mapped one
+    for (const char *invalid : {"p cnf 3 1\n1 -4 0\n", "p cnf 3 1\n-2147483648 0\n"}) {
+        std::stringstream stream(invalid);
+        bool thrown = false;
+        try {
+            CNF cnf(stream);
+        } catch (const std::invalid_argument &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
+void test_compressed() {
+    CNF plain("data/hanoi/hanoi4.cnf");
+    std::pair<const char *, InputStream::Format> files[] = {
+            {"data/compressed/hanoi4.cnf.gz", InputStream::GZIP}, {"data/compressed/hanoi4.cnf.xz", InputStream::XZ}};
+    for (const auto &[path, format] : files) {
+        if (!InputStream::supported(format))
+            continue;
+        CNF compressed(path);
+        assert(compressed.num_vars() == plain.num_vars() and compressed.num_clauses() == plain.num_clauses());
+        assert(compressed.get_clauses() == plain.get_clauses());
+    }
+
+    // lines split between chunks of any size
+    std::ifstream fin("data/uf50/uf50-01.cnf");
+    std::string text((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+    DimacsData whole;
+    parse_dimacs(text.data(), text.data() + text.size(), whole);
+    for (size_t chunk : {1, 7, 100}) {
+        DimacsData data;
+        DimacsParser parser(data);
+        for (size_t i = 0; i < text.size(); i += chunk)
+            parser.feed(text.data() + i, text.data() + std::min(text.size(), i + chunk));
+        parser.finish();
+        assert(data.literals == whole.literals and data.clauses_read == whole.clauses_read);
+    }
+}
+
+void test_binary() {
+    // a name of its own, so that concurrent runs do not overwrite each other's file
+    char name[] = "/tmp/task3_test_XXXXXX";
+    int fd = mkstemp(name);
+    assert(fd >= 0);
+    close(fd);
+    const std::string path = name;
+    for (const char *source : {"data/uf50/uf50-01.cnf", "data/hanoi/hanoi4.cnf"}) {
+        CNF text(source);
+        {
+            std::ofstream fout(path, std::ios::binary);
+            text.write_binary(fout);
+        }
+        CNF binary(path);
+        assert(binary.num_vars() == text.num_vars() and binary.num_clauses() == text.num_clauses());
+        assert(binary.get_clauses() == text.get_clauses());
+    }
+
+    // one flipped bit of a literal or of the header is caught by the checksum,
+    // a number of clauses above the number of literals even before it
+    std::string bytes;
+    {
+        std::ifstream fin(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    }
+    size_t offsets[] = {sizeof(BinaryHeader) + 3, offsetof(BinaryHeader, var_num), offsetof(BinaryHeader, clause_num) + 7};
+    for (size_t offset : offsets) {
+        std::string corrupted_bytes = bytes;
+        corrupted_bytes[offset] ^= char(0x80);
+        {
+            std::ofstream fout(path, std::ios::binary);
+            fout << corrupted_bytes;
+        }
+        bool thrown = false;
+        try {
+            CNF corrupted(path);
+        } catch (const std::invalid_argument &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    // a checksum does not make a huge number of variables acceptable
+    BinaryHeader header{};
+    memcpy(&header, bytes.data(), sizeof(header));
+    header.var_num = uint64_t(1) << 32;
+    header.checksum = binary_checksum(header, reinterpret_cast<const int32_t *>(bytes.data() + sizeof(header)));
+    memcpy(&bytes[0], &header, sizeof(header));
+    {
+        std::ofstream fout(path, std::ios::binary);
+        fout << bytes;
+    }
+    bool thrown = false;
+    try {
+        CNF huge(path);
+    } catch (const std::invalid_argument &e) {
+        thrown = std::string(e.what()).find("too many variables") != std::string::npos;
+    }
+    assert(thrown);
+    std::remove(path.c_str());
+}
+
+void test_clause_arena() {
+    ClauseArena arena;
+    int literals[] = {1, -2, 3, -4};
+    ClauseRef first = arena.alloc(literals, 2);
+    ClauseRef second = arena.alloc(literals + 1, 3, true);
+    ClauseRef third = arena.alloc(literals, 4);
+    arena.free(second);
+    assert(arena.wasted_bytes() > 0);
+
+    Relocation relocation = arena.compact();
+    assert(arena.wasted_bytes() == 0);
+    assert(relocation(first) == first);
+    assert(relocation(second) == ClauseArena::NO_CLAUSE);
+    assert(std::vector<int>(arena[relocation(third)].begin(), arena[relocation(third)].end())
+        == std::vector<int>(literals, literals + 4));
+}
+
+void test_restarts() {
+    std::vector<uint64_t> sequence;
+    for (uint64_t i = 0; i < 15; i++)
+        sequence.push_back(LubyRestarts::luby(i));
+    assert(sequence == std::vector<uint64_t>({1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8}));
+
+    SolverConfig config;
+    config.restarts = RestartPolicy::LUBY;
+    config.restart_interval = 1;
+    Solver solver(CNF("data/pigeon-hole/hole7.cnf"), config);
+    assert(!solver.solve());
+    assert(solver.stats().restarts > 0 or !Counter::ENABLED);
+}
+
+void test_incremental() {
+    Solver solver;
+    solver.add_clause({1, 2});
+    solver.add_clause({-1, 3});
+    assert(solver.solve());
+    assert(!solver.solve({-2, -3}));
+    assert(solver.failed_assumptions().size() == 2);
+    assert(solver.solve({-2}));
+
+    solver.add_clause({-3, 4});
+    solver.add_clause({-4, -1});
+    assert(!solver.solve({5, 1}));
+    assert(solver.failed_assumptions() == std::vector<int>({1}));
+
+    // repeated assumptions keep their empty levels, the search goes deeper than there are variables
+    Solver repeated;
+    for (int a : {-2, 2})
+        for (int b : {-3, 3})
+            for (int c : {-4, 4})
+                repeated.add_clause({a, b, c});
+    assert(!repeated.solve({1, 1, 1, 1, 1, 1, 1, 1}) and repeated.failed_assumptions().empty());
+    assert(solver.num_vars() == 5);
+
+    solver.add_clause({-1});
+    assert(!solver.solve({-2}));
+    assert(solver.failed_assumptions() == std::vector<int>({-2}));
+    assert(solver.solve());
+    solver.add_clause({-2});
+    assert(!solver.solve());
+    assert(solver.failed_assumptions().empty());
+}
+
+void test_preprocessor() {
+    CNF cnf("data/hanoi/hanoi4.cnf");
+    Preprocessor preprocessor(cnf);
+    assert(preprocessor.run());
+    assert(preprocessor.simplified().num_clauses() < cnf.num_clauses());
+    assert(preprocessor.stats().duplicates > 0 and preprocessor.stats().eliminated_vars > 0);
+
+    Solver solver(cnf);
+    assert(solver.solve());
+    assert(check_model(cnf, solver.model()));
+    size_t var = 0;
+    while (!solver.get_preprocessor()->is_eliminated(var))
+        var++;
+    solver.add_clause({int(var + 1)});
+    assert(!solver.get_preprocessor()->is_eliminated(var));
+    assert(solver.solve());
+    assert(check_model(cnf, solver.model()) and solver.model()[var]);
+
+    // 1 is pure, the clauses and assumptions added later bring its clauses back
+    std::stringstream dimacs("p cnf 3 3\n1 2 0\n1 -3 0\n2 3 0\n");
+    CNF pure(dimacs);
+    Solver pure_solver(pure);
+    assert(pure_solver.get_preprocessor()->is_eliminated(0));
+    pure_solver.add_clause({-1});
+    assert(!pure_solver.solve({-2}));
+    assert(pure_solver.solve());
+    assert(check_model(pure, pure_solver.model()) and !pure_solver.model()[0]);
+    Solver assumed_solver(pure);
+    assert(assumed_solver.solve({-1}));
+    assert(check_model(pure, assumed_solver.model()) and !assumed_solver.model()[0]);
+
+    SolverConfig config;
+    config.frozen = {1};
+    Solver frozen_solver(pure, config);
+    assert(!frozen_solver.get_preprocessor()->is_eliminated(0));
+
+    for (int i = 1; i <= 100; i++) {
+        CNF random_cnf("data/uf50/uf50-0" + std::to_string(i) + ".cnf");
+        Solver random_solver(random_cnf);
+        assert(random_solver.solve());
+        assert(check_model(random_cnf, random_solver.model()));
+    }
+}
+
+void test_proof() {
+    CNF cnf("data/pigeon-hole/hole7.cnf");
+    std::stringstream proof;
+    {
+        ProofWriter writer(proof, 256);
+        Solver solver(cnf, SolverConfig(), &writer);
+        assert(!solver.solve());
+        writer.flush();
+        assert(writer.bytes() == proof.str().size());
+    }
+    DratChecker checker(cnf);
+    assert(checker.check(proof));
+    assert(checker.lemmas() > 0);
+
+    // the empty clause alone does not follow by unit propagation
+    std::stringstream empty_clause(std::string("a\0", 2));
+    DratChecker shortcut(cnf);
+    assert(!shortcut.check(empty_clause));
+    // a huge variable is rejected instead of sizing the tables by it, a new one is the pivot of a RAT lemma
+    std::stringstream huge_var(std::string("a\xfe\xff\xff\xff\x07\0", 7));
+    for (const std::string &malformed : {std::string("a\x01\0", 3), std::string("a\xff\xff\xff\xff\x1f\0", 7)}) {
+        std::stringstream malformed_proof(malformed);
+        DratChecker rejecting(cnf);
+        assert(!rejecting.check(malformed_proof) and rejecting.error().find("Malformed literal") == 0);
+    }
+    DratChecker huge(cnf);
+    assert(!huge.check(huge_var) and huge.error().find("out of range") != std::string::npos);
+    std::stringstream extension(std::string("d\xfe\xff\xff\xff\x07\0a\x72\0", 10));
+    DratChecker extended(cnf);
+    assert(!extended.check(extension) and extended.lemmas() == 1);
+    assert(extended.error() == "The proof does not derive the empty clause");
+
+    std::vector<bool> model;
+    CNF satisfiable("data/uf50/uf50-01.cnf");
+    assert(satisfiable.is_sat(SolverConfig(), model));
+    assert(check_model(satisfiable, model));
+    SolverConfig dpll;
+    dpll.algorithm = CNF::DPLL;
+    assert(satisfiable.is_sat(dpll, model));
+    assert(check_model(satisfiable, model));
+}
+
+void test_reduce() {
+    // frequent reductions keep the answers and the proofs right
+    CNF cnf("data/pigeon-hole/hole7.cnf");
+    SolverConfig config;
+    config.reduce_interval = 100;
+    config.reduce_increment = 10;
+    std::stringstream proof;
+    {
+        ProofWriter writer(proof);
+        Solver solver(cnf, config, &writer);
+        assert(!solver.solve());
+        assert(solver.stats().reduced_clauses > 0 or !Counter::ENABLED);
+    }
+    DratChecker checker(cnf);
+    assert(checker.check(proof) and checker.deletions() > 0);
+
+    config = SolverConfig();
+    config.memory_budget = 64 * 1024;
+    CNF hole8("data/pigeon-hole/hole8.cnf");
+    Solver bounded(hole8, config);
+    assert(!bounded.solve());
+    assert(bounded.memory_bytes() > 0);
+    if (Counter::ENABLED)
+        assert(bounded.stats().reductions > 0 and bounded.stats().learned_bytes < 4 * config.memory_budget);
+
+    // the core clauses alone take more than a tiny budget, that must not reduce on every conflict
+    config.memory_budget = 256;
+    for (auto [path, satisfiable] : {std::pair("data/pigeon-hole/hole7.cnf", false), std::pair("data/hanoi/hanoi4.cnf", true)}) {
+        CNF tiny_cnf(path);
+        Solver tiny(tiny_cnf, config);
+        assert(tiny.solve() == satisfiable);
+        if (Counter::ENABLED)
+            assert(tiny.stats().reductions > 0 and tiny.stats().reductions < tiny.stats().conflicts / 2);
+    }
+}
+
+void test_stats() {
+    SolverConfig config;
+    config.progress_interval = 1e9;
+    Solver solver(CNF("data/pigeon-hole/hole7.cnf"), config);
+    assert(!solver.solve());
+
+    std::stringstream json;
+    solver.stats().write_json(json);
+    assert(json.str().find("\"learned_clauses\": ") != std::string::npos);
+    if (!Counter::ENABLED)
+        return;
+    const SolverStats &stats = solver.stats();
+    assert(stats.conflicts > 0 and stats.learned_clauses + 1 == stats.conflicts);
+    assert(stats.backtracks == stats.learned_clauses and stats.max_level > 0);
+    assert(stats.solve_seconds > 0 and stats.propagate_seconds + stats.analyze_seconds <= stats.solve_seconds);
+    assert(stats.propagate_seconds > 0 or !Counter::DETAILED);
+}
+
+void test_generator() {
+    assert(!pigeon_hole(5).is_sat());
+    assert(!graph_coloring(6, 100, 5, 0).is_sat());
+    assert(!parity(12, false, 1).is_sat());
+
+    for (const auto &cnf : {random_ksat(50, 3, 2.0, 7), graph_coloring(50, 100, 4, 7), parity(20, true, 7)}) {
+        std::vector<bool> model;
+        assert(cnf.is_sat(SolverConfig(), model) and check_model(cnf, model));
+    }
+
+    CNF cnf = random_ksat(100, 4, 5.0, 3);
+    assert(cnf.num_vars() == 100 and cnf.num_clauses() == 500);
+    std::stringstream dimacs;
+    cnf.write_dimacs(dimacs);
+    CNF parsed(dimacs);
+    assert(parsed.num_vars() == cnf.num_vars() and parsed.num_clauses() == cnf.num_clauses());
+    auto it = parsed.get_clauses().begin();
+    for (auto clause : cnf.get_clauses()) {
+        assert(std::equal(clause.begin(), clause.end(), (*it).begin(), (*it).end()));
+        ++it;
+    }
+}
+
+void test_bit_dpll() {
+    std::vector<CNF> formulas = {pigeon_hole(6), parity(15, true, 3), parity(15, false, 3), random_ksat(64, 3, 4.26, 5)};
+    for (int i = 1; i <= 50; i++) {
+        formulas.emplace_back("data/uf50/uf50-0" + std::to_string(i) + ".cnf");
+        formulas.emplace_back("data/uuf50/uuf50-0" + std::to_string(i) + ".cnf");
+    }
+    for (auto kernel : {BitDpll::SCALAR, BitDpll::SSE, BitDpll::AVX2}) {
+        if (!BitDpll::supported(kernel))
+            continue;
+        for (auto heuristic : {Heuristic::FIRST_UNASSIGNED, Heuristic::VSIDS}) {
+            SolverConfig config;
+            config.algorithm = CNF::DPLL;
+            config.heuristic = heuristic;
+            for (const auto &cnf : formulas) {
+                BitDpll solver(cnf, config, kernel);
+                bool is_sat = solver.solve();
+                assert(is_sat == Solver(cnf).solve());
+                assert(!is_sat or check_model(cnf, solver.model()));
+            }
+        }
+    }
+    assert(!BitDpll::fits(pigeon_hole(8)));
+}
+
+void test_local_search() {
+    for (auto kind : {LocalSearchConfig::WALKSAT, LocalSearchConfig::PROBSAT}) {
+        LocalSearchConfig config;
+        config.kind = kind;
+        for (int i = 1; i <= 100; i++) {
+            CNF cnf("data/uf50/uf50-0" + std::to_string(i) + ".cnf");
+            LocalSearch search(cnf, config);
+            assert(search.solve() and check_model(cnf, search.model()));
+        }
+        // every literal twice, the counters must not see it twice
+        CNF cnf("data/uf50/uf50-01.cnf");
+        ClauseArena doubled;
+        for (auto clause : cnf.get_clauses()) {
+            std::vector<int> literals;
+            for (int literal : clause)
+                literals.insert(literals.end(), {literal, literal});
+            doubled.alloc(literals.data(), literals.size());
+        }
+        CNF repeated(cnf.num_vars(), std::move(doubled));
+        LocalSearch repeated_search(repeated, config);
+        assert(repeated_search.solve() and check_model(cnf, repeated_search.model()));
+
+        config.max_flips = 10000;
+        CNF unsat("data/uuf50/uuf50-01.cnf");
+        LocalSearch search(unsat, config);
+        assert(!search.solve() and search.flips() == 10000);
+    }
+
+    SolverConfig config;
+    config.local_search = true;
+    std::vector<bool> model;
+    CNF cnf = random_ksat(2000, 3, 4.0, 1);
+    assert(cnf.is_sat(config, model) and check_model(cnf, model));
+    assert(!CNF("data/pigeon-hole/hole7.cnf").is_sat(config));
+}
+
+void test_cube_and_conquer() {
+    CNF pigeon("data/pigeon-hole/hole7.cnf");
+    CubeAndConquer unsat(pigeon, 4);
+    assert(!unsat.solve() and unsat.get_cubes().size() + unsat.refuted_cubes() >= 2);
+    for (const auto &cube : unsat.get_cubes())
+        assert(cube.size() >= 5);
+
+    for (int i = 1; i <= 20; i++) {
+        CNF cnf("data/uf50/uf50-0" + std::to_string(i) + ".cnf");
+        CubeAndConquer sat(cnf, 2, 3);
+        assert(sat.solve() and check_model(cnf, sat.model()));
+    }
+}
+
+void test_batch() {
+    auto results = solve_batch(expand_paths({"data/uf50/uf50-01?.cnf", "data/uuf50/uuf50-01?.cnf"}), SolverConfig());
+    assert(results.size() == 20);
+    for (const auto &result : results) {
+        assert(result.error.empty());
+        bool is_sat = result.path.find("/uf50") != std::string::npos;
+        assert(result.result == (is_sat ? CNF::BoolTernary::TRUE : CNF::BoolTernary::FALSE));
+        assert(result.stats.propagations > 0 or !Counter::ENABLED);
+    }
+
+    // a failed task does not stop the others, its exception comes out of wait once
+    ThreadPool pool(2);
+    std::atomic<int> finished(0);
+    pool.submit([]() { throw std::runtime_error("task failed"); });
+    for (int i = 0; i < 10; i++)
+        pool.submit([&finished]() { finished++; });
+    bool thrown = false;
+    try {
+        pool.wait();
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown and finished == 10);
+    pool.wait();
+}
+
 int main() {
-    test_directory("data/uf50/uf50-0", 1, 1000, true, "uf50");
-    test_directory("data/uuf50/uuf50-0", 1, 1000, false, "uuf50");
-    test_directory("data/pigeon-hole/hole", 6, 8, false, "pigeon");
-    test_directory("data/hanoi/hanoi", 4, 4, true, "hanoi");
+    test_parser();
+    test_compressed();
+    test_binary();
+    test_clause_arena();
+    test_restarts();
+    test_incremental();
+    test_preprocessor();
+    test_proof();
+    test_reduce();
+    test_stats();
+    test_generator();
+    test_bit_dpll();
+    test_local_search();
+    test_cube_and_conquer();
+    test_batch();
+    for (auto algorithm : {CNF::DPLL, CNF::CDCL}) {
+        for (auto heuristic : {Heuristic::FIRST_UNASSIGNED, Heuristic::VSIDS}) {
+            SolverConfig config;
+            config.algorithm = algorithm;
+            config.heuristic = heuristic;
+            // the first unassigned variable with FALSE first is the original solver
+            config.phase_saving = heuristic != Heuristic::FIRST_UNASSIGNED;
+            std::string suffix = std::string(" (") + (algorithm == CNF::DPLL ? "DPLL" : "CDCL") + ", "
+                    + (heuristic == Heuristic::VSIDS ? "VSIDS" : "first unassigned") + ")";
+
+            auto solve = [&config](const CNF &cnf) { return cnf.is_sat(config); };
+            test_directory("data/uf50/uf50-0", 1, 1000, true, "uf50" + suffix, solve);
+            test_directory("data/uuf50/uuf50-0", 1, 1000, false, "uuf50" + suffix, solve);
+            test_directory("data/pigeon-hole/hole", 6, 8, false, "pigeon" + suffix, solve);
+            test_directory("data/hanoi/hanoi", 4, 4, true, "hanoi" + suffix, solve);
+        }
+    }
+
+    for (auto restarts : {RestartPolicy::NONE, RestartPolicy::LUBY, RestartPolicy::GEOMETRIC}) {
+        SolverConfig config;
+        config.restarts = restarts;
+        std::string suffix = std::string(" (CDCL, VSIDS, ")
+                + (restarts == RestartPolicy::NONE ? "no" : restarts == RestartPolicy::LUBY ? "Luby" : "geometric")
+                + " restarts)";
+
+        auto solve = [&config](const CNF &cnf) { return cnf.is_sat(config); };
+        test_directory("data/uuf50/uuf50-0", 1, 100, false, "uuf50" + suffix, solve);
+        test_directory("data/pigeon-hole/hole", 6, 8, false, "pigeon" + suffix, solve);
+        test_directory("data/hanoi/hanoi", 4, 4, true, "hanoi" + suffix, solve);
+    }
+
+    auto portfolio = [](const CNF &cnf) { return Portfolio(cnf, 4).solve(); };
+    test_directory("data/uf50/uf50-0", 1, 100, true, "uf50 (portfolio of 4)", portfolio);
+    test_directory("data/uuf50/uuf50-0", 1, 100, false, "uuf50 (portfolio of 4)", portfolio);
+    test_directory("data/pigeon-hole/hole", 6, 8, false, "pigeon (portfolio of 4)", portfolio);
+    test_directory("data/hanoi/hanoi", 4, 4, true, "hanoi (portfolio of 4)", portfolio);
+
+    auto cube_and_conquer = [](const CNF &cnf) { return CubeAndConquer(cnf, 4).solve(); };
+    test_directory("data/uf50/uf50-0", 1, 100, true, "uf50 (cube and conquer, 4 workers)", cube_and_conquer);
+    test_directory("data/uuf50/uuf50-0", 1, 100, false, "uuf50 (cube and conquer, 4 workers)", cube_and_conquer);
+    test_directory("data/pigeon-hole/hole", 6, 8, false, "pigeon (cube and conquer, 4 workers)", cube_and_conquer);
+    test_directory("data/hanoi/hanoi", 4, 4, true, "hanoi (cube and conquer, 4 workers)", cube_and_conquer);
+
+    SolverConfig hybrid;
+    hybrid.local_search = true;
+    auto local_search = [](const CNF &cnf) { return LocalSearch(cnf).solve(); };
+    auto solve_hybrid = [&hybrid](const CNF &cnf) { return cnf.is_sat(hybrid); };
+    test_directory("data/uf50/uf50-0", 1, 1000, true, "uf50 (ProbSAT)", local_search);
+    test_directory("data/uf50/uf50-0", 1, 1000, true, "uf50 (CDCL with ProbSAT)", solve_hybrid);
+    test_directory("data/uuf50/uuf50-0", 1, 1000, false, "uuf50 (CDCL with ProbSAT)", solve_hybrid);
+    test_directory("data/pigeon-hole/hole", 6, 8, false, "pigeon (CDCL with ProbSAT)", solve_hybrid);
+    test_directory("data/hanoi/hanoi", 4, 4, true, "hanoi (CDCL with ProbSAT)", solve_hybrid);
     return 0;
 }
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <utility>
+#include "thread_pool.hpp"
+
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < threads; i++)
+        queues.push_back(std::make_unique<Queue>());
+    for (size_t i = 0; i < threads; i++)
+        workers.emplace_back(&ThreadPool::run, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    task_added.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+
+void ThreadPool::submit(std::function<void()> task) {
+    auto &queue = *queues[next_queue++ % queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued++;
+        pending++;
+    }
+    task_added.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    all_done.wait(lock, [this]() { return pending == 0; });
+    if (error)
+        std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+
+bool ThreadPool::pop(size_t index, std::function<void()> &task) {
+    for (size_t i = 0; i < queues.size(); i++) {
+        auto &queue = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+        if (i == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run(size_t index) {
+    while (true) {
+        std::function<void()> task;
+        if (pop(index, task)) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queued--;
+            }
+            std::exception_ptr failure;
+            try {
+                task();
+            } catch (...) {
+                // leaving the worker would terminate the process
+                failure = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (failure and !error)
+                error = failure;
+            if (--pending == 0)
+                all_done.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        task_added.wait(lock, [this]() { return stopping or queued > 0; });
+        if (stopping and queued == 0)
+            return;
+    }
+}
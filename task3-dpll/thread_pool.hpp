@@ -0,0 +1,54 @@
+#ifndef TASK3_THREAD_POOL_HPP
+#define TASK3_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Fixed set of worker threads with a task deque per worker. A worker takes the newest
+// task of its own deque and steals the oldest task of another deque when its own is empty.
+class ThreadPool {
+
+public:
+    explicit ThreadPool(size_t threads = 0); // 0 - one per core
+    ~ThreadPool();                           // runs the queued tasks to the end
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool& operator =(const ThreadPool &) = delete;
+
+    void submit(std::function<void()> task);
+    // blocks until all submitted tasks are finished, then rethrows the first exception
+    // that a task has thrown since the last wait, the other tasks still run to the end
+    void wait();
+
+    [[nodiscard]] size_t size() const { return workers.size(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> next_queue{0};
+
+    std::mutex mutex;
+    std::condition_variable task_added;
+    std::condition_variable all_done;
+    size_t queued = 0;  // tasks in the deques
+    size_t pending = 0; // tasks not finished yet
+    bool stopping = false;
+    std::exception_ptr error; // of the first failed task
+
+    void run(size_t index);
+    bool pop(size_t index, std::function<void()> &task);
+};
+
+#endif //TASK3_THREAD_POOL_HPP